@@ -0,0 +1,140 @@
+/*
+* File : arena.h
+* ---------------
+* Defines the Arena class template which creates objects of one type in
+* large blocks of memory instead of one by one with new, and destroys
+* them all at once when the arena goes. Objects never move once they are
+* created, so pointers to them stay valid for as long as the arena lives.
+* The Chart keeps its Positions and Links in arenas, which puts them next
+* to each other in memory and makes loading or freeing a chart cost a
+* handful of allocations rather than one per object.
+*
+* Implementation notes
+* ---------------------
+* Every block is raw memory for a number of objects, which are copy
+* constructed into it in order with placement new. reserve lets a caller
+* that knows how many objects are coming get them all in a single block.
+* An arena can't be copied, since the copy would free the same blocks.
+*/
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <new>
+#include <vector>
+
+const int DEFAULT_ARENA_BLOCK_SIZE = 1024;
+
+template <typename ElemType>
+class Arena{
+public:
+	/*
+	* Function : Constructor function for the Arena class
+	* Usage    : Arena<Link> links;
+	* ------------------------------
+	* Creates an empty arena, blocks hold blockSize objects unless reserve
+	* asks for more.
+	*/
+	Arena(int blockSize = DEFAULT_ARENA_BLOCK_SIZE);
+
+	/*
+	* Function : Destructor function for the Arena class
+	* ---------------------------------------------------
+	* Destroys every object created in the arena and frees its memory.
+	*/
+	~Arena();
+
+	/*
+	* Function : reserve
+	* Usage    : links.reserve(numLinks);
+	* ------------------------------------
+	* Makes sure the next count objects created fit in the block in use,
+	* starting a block big enough for them if they don't.
+	*/
+	void reserve(int count);
+
+	/*
+	* Function : create
+	* Usage    : Link * link = links.create(Link(start, end, cost, id));
+	* ---------------------------------------------------------------
+	* Copies value into the arena and returns a pointer to the copy.
+	*/
+	ElemType * create(const ElemType &value);
+
+	/*
+	* Function : clear
+	* Usage    : links.clear();
+	* --------------------------
+	* Destroys every object created so far and frees all the blocks.
+	*/
+	void clear();
+
+	int size();
+
+private:
+	std::vector<ElemType *> blocks;
+	std::vector<int> blockUsed;       // objects created in each block
+	int defaultBlockSize;
+	int lastBlockSize;
+	int count;
+
+	void addBlock(int numElems);
+
+	Arena(const Arena &);
+	Arena & operator=(const Arena &);
+};
+
+template <typename ElemType>
+Arena<ElemType>::Arena(int blockSize){
+	defaultBlockSize = (blockSize > 0) ? blockSize : 1;
+	lastBlockSize = 0;
+	count = 0;
+}
+
+template <typename ElemType>
+Arena<ElemType>::~Arena(){
+	clear();
+}
+
+template <typename ElemType>
+void Arena<ElemType>::reserve(int numElems){
+	if(blocks.empty() || lastBlockSize - blockUsed.back() < numElems) addBlock(numElems);
+}
+
+template <typename ElemType>
+ElemType * Arena<ElemType>::create(const ElemType &value){
+	if(blocks.empty() || blockUsed.back() == lastBlockSize) addBlock(defaultBlockSize);
+	ElemType * elem = blocks.back() + blockUsed.back();
+	new (elem) ElemType(value);
+	blockUsed.back()++;
+	count++;
+	return elem;
+}
+
+template <typename ElemType>
+void Arena<ElemType>::clear(){
+	for(int i = 0; i < (int)blocks.size(); i++){
+		for(int j = 0; j < blockUsed[i]; j++)
+			blocks[i][j].~ElemType();
+		::operator delete(blocks[i]);
+	}
+	blocks.clear();
+	blockUsed.clear();
+	lastBlockSize = 0;
+	count = 0;
+}
+
+template <typename ElemType>
+int Arena<ElemType>::size(){
+	return count;
+}
+
+template <typename ElemType>
+void Arena<ElemType>::addBlock(int numElems){
+	if(numElems < defaultBlockSize) numElems = defaultBlockSize;
+	blocks.push_back(static_cast<ElemType *>(::operator new(numElems * sizeof(ElemType))));
+	blockUsed.push_back(0);
+	lastBlockSize = numElems;
+}
+
+#endif
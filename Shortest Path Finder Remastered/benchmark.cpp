@@ -0,0 +1,268 @@
+/*
+* File : benchmark.cpp
+* ---------------------
+* A command line tool that times the path finder on made up charts (see
+* chartgenerator.h) of growing size, so that changes that make it slower
+* show up.
+*
+* Usage : benchmark [-q numQueries] [-s seed] [-o results.csv] [-large]
+*                   [kind:size ...]
+*
+* Every kind:size (e.g. road:1000000, kinds are grid, geometric and road)
+* is generated and written out as a text data file (bench_road_1000000.txt),
+* then loaded and searched. Leave them out to run every kind at 1000,
+* 10000 and 100000 positions, or with -large at 1000 up to 10000000.
+* The large sizes are left out by default because they take long and a
+* chart of ten million positions needs about 3.5 GB, more than a 32 bit
+* build can address, so -large is meant for 64 bit builds. The measures
+* taken for every chart are
+*
+* generate_s           making the chart up and writing it out
+* load_text_s          loading it from text, which also compiles it
+* load_compiled_s      loading it again from the compiled file
+* <mode>_p50_ms ...    query time percentiles (p50, p90, p99, max) for
+*                      every search mode over the same random pairs
+* hierarchy_prepare_s  building and saving the contraction hierarchy
+* ten_paths_p50_ms ... finding the ten shortest paths between each pair
+* reachable_p50_ms ... finding every position and link within half the
+*                      cost of each query's shortest path
+* mst_kruskal_s ...    finding the minimal spanning tree, one measure
+*                      for each spanning tree mode
+* link_update_p50_ms ...
+*                      changing the cost of a random link, which also
+*                      repairs the search trees cached by the queries
+* heap_s               queuing and dequeuing every position id on an
+*                      IndexedHeap
+* heap_arity2_s ...    full Dijkstra searches from a few random starts
+*                      on an IndexedHeap of arity 2, 4 and 8, to tell
+*                      which suits the way searches use the heap best
+*
+* Each measure is printed as a line of comma separated values, kind,
+* positions, links, measure, value, and the same lines go to the results
+* file (benchmark_results.csv unless -o says otherwise). This file has
+* its own main and is built as a separate console program, like
+* chartcompiler.cpp: benchmark.vcproj in the solution (build it in the
+* Release configuration for numbers worth comparing), or elsewhere
+*
+*     g++ -O2 -fopenmp -I<CS106 include dir> -o benchmark benchmark.cpp
+*/
+
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include "chart.h"
+#include "chartgenerator.h"
+#include "stopwatch.h"
+
+struct benchmarkT{
+	graphKindT kind;
+	int numPositions;
+};
+
+FILE * resultsFile = NULL;
+
+void reportMeasure(const benchmarkT &bench, int numLinks, string measure, double value){
+	char line[256];
+	sprintf(line, "%s,%d,%d,%s,%.6f\n", graphKindName(bench.kind).c_str(), bench.numPositions,
+		numLinks, measure.c_str(), value);
+	cout<<line;
+	if(resultsFile != NULL) fputs(line, resultsFile);
+}
+
+// Reports the 50th, 90th and 99th percentile and the largest of the given times
+void reportPercentiles(const benchmarkT &bench, int numLinks, string name, std::vector<double> &times){
+	if(times.empty()) return;
+	std::sort(times.begin(), times.end());
+	double percentiles[] = {0.5, 0.9, 0.99};
+	string labels[] = {"_p50_ms", "_p90_ms", "_p99_ms"};
+	for(int i = 0; i < 3; i++){
+		int index = (int)std::ceil(percentiles[i] * times.size()) - 1;
+		reportMeasure(bench, numLinks, name + labels[i], times[std::max(index, 0)] * 1000);
+	}
+	reportMeasure(bench, numLinks, name + "_max_ms", times.back() * 1000);
+}
+
+// Settles the whole graph from every start with a heap of the given arity, returns the time taken
+template <int Arity>
+double timeDijkstraWithArity(const CSRGraph &graph, const std::vector<int> &starts){
+	std::vector<double> distances(graph.numNodes());
+	IndexedHeap<double, std::less<double>, Arity> frontier(graph.numNodes());
+	Stopwatch watch;
+	for(int i = 0; i < (int)starts.size(); i++){
+		distances.assign(graph.numNodes(), INFINITE_DISTANCE);
+		distances[starts[i]] = 0;
+		frontier.enqueue(starts[i], 0);
+		while(!frontier.isEmpty()){
+			int node = frontier.dequeueMin();
+			for(int edge = graph.firstEdge(node); edge < graph.endEdge(node); edge++){
+				int target = graph.getTarget(edge);
+				double distance = distances[node] + graph.getCost(edge);
+				if(distance >= distances[target]) continue;
+				if(distances[target] == INFINITE_DISTANCE) frontier.enqueue(target, distance);
+				else frontier.decreaseKey(target, distance);
+				distances[target] = distance;
+			}
+		}
+	}
+	return watch.getSeconds();
+}
+
+string positionName(int posId){
+	char name[16];
+	sprintf(name, "p%d", posId);
+	return name;
+}
+
+void runBenchmark(const benchmarkT &bench, int numQueries, unsigned int seed){
+	char fileName[64];
+	sprintf(fileName, "bench_%s_%d.txt", graphKindName(bench.kind).c_str(), bench.numPositions);
+	remove(compiledChartName(fileName).c_str());
+	remove(hierarchyFileName(fileName).c_str());
+
+	Stopwatch watch;
+	ChartData data;
+	generateChart(bench.kind, bench.numPositions, seed, data);
+	if(!writeChartText(fileName, data)) Error(string("Can't write ") + fileName);
+	int numLinks = data.numLinks();
+	CSRGraph graph;
+	graph.build(data.numPositions(), data.linkStarts, data.linkEnds, data.linkCosts);
+	data = ChartData();
+	reportMeasure(bench, numLinks, "generate_s", watch.getSeconds());
+
+	watch.restart();
+	{
+		Chart textChart(fileName);
+	}
+	reportMeasure(bench, numLinks, "load_text_s", watch.getSeconds());
+
+	watch.restart();
+	Chart chart(fileName);
+	reportMeasure(bench, numLinks, "load_compiled_s", watch.getSeconds());
+
+	RandomStream random(seed + 1);
+	std::vector<string> starts, ends;
+	for(int i = 0; i < numQueries; i++){
+		starts.push_back(positionName((int)(random.nextDouble() * bench.numPositions)));
+		ends.push_back(positionName((int)(random.nextDouble() * bench.numPositions)));
+	}
+
+	watch.restart();
+	chart.getShortestPathBetween(starts[0], starts[0], HIERARCHY_SEARCH);
+	reportMeasure(bench, numLinks, "hierarchy_prepare_s", watch.getSeconds());
+
+	searchModeT modes[] = {DIJKSTRA_SEARCH, ASTAR_SEARCH, BIDIRECTIONAL_SEARCH, HIERARCHY_SEARCH};
+	string modeNames[] = {"dijkstra", "astar", "bidirectional", "hierarchy"};
+	for(int m = 0; m < 4; m++){
+		std::vector<double> times;
+		for(int i = 0; i < numQueries; i++){
+			watch.restart();
+			chart.getShortestPathBetween(starts[i], ends[i], modes[m]);
+			times.push_back(watch.getSeconds());
+		}
+		reportPercentiles(bench, numLinks, modeNames[m], times);
+	}
+
+	std::vector<double> alternativeTimes;
+	for(int i = 0; i < numQueries; i++){
+		watch.restart();
+		chart.getShortestPathsBetween(starts[i], ends[i], 10);
+		alternativeTimes.push_back(watch.getSeconds());
+	}
+	reportPercentiles(bench, numLinks, "ten_paths", alternativeTimes);
+
+	// Everything within half the cost of each query's shortest path
+	std::vector<double> reachableTimes;
+	for(int i = 0; i < numQueries; i++){
+		double budget = chart.getShortestPathBetween(starts[i], ends[i], HIERARCHY_SEARCH).getTotalPathCost() / 2;
+		watch.restart();
+		chart.getReachableWithin(starts[i], budget, true);
+		reachableTimes.push_back(watch.getSeconds());
+	}
+	reportPercentiles(bench, numLinks, "reachable", reachableTimes);
+
+	spanningTreeModeT treeModes[] = {KRUSKAL_TREE, BORUVKA_TREE, FILTER_KRUSKAL_TREE};
+	string treeModeNames[] = {"mst_kruskal_s", "mst_boruvka_s", "mst_filter_kruskal_s"};
+	for(int m = 0; m < 3; m++){
+		watch.restart();
+		chart.getMinimalSpanningTree(treeModes[m]);
+		reportMeasure(bench, numLinks, treeModeNames[m], watch.getSeconds());
+	}
+
+	// Traffic on random links, the trees cached by the dijkstra queries are repaired every time
+	std::vector<double> updateTimes;
+	for(int i = 0; i < numQueries; i++){
+		int linkId = (int)(random.nextDouble() * numLinks);
+		Link * link = chart.getLinkBetween(positionName(graph.getLinkStart(linkId)), positionName(graph.getLinkEnd(linkId)));
+		double cost = link->getCost() * random.nextDouble(0.5, 1.5);
+		watch.restart();
+		chart.setLinkCost(link, cost);
+		updateTimes.push_back(watch.getSeconds());
+	}
+	reportPercentiles(bench, numLinks, "link_update", updateTimes);
+
+	IndexedHeap<double> heap(bench.numPositions);
+	watch.restart();
+	for(int id = 0; id < bench.numPositions; id++)
+		heap.enqueue(id, random.nextDouble());
+	while(!heap.isEmpty())
+		heap.dequeueMin();
+	reportMeasure(bench, numLinks, "heap_s", watch.getSeconds());
+
+	std::vector<int> searchStarts;
+	for(int i = 0; i < 10; i++)
+		searchStarts.push_back((int)(random.nextDouble() * bench.numPositions));
+	reportMeasure(bench, numLinks, "heap_arity2_s", timeDijkstraWithArity<2>(graph, searchStarts));
+	reportMeasure(bench, numLinks, "heap_arity4_s", timeDijkstraWithArity<4>(graph, searchStarts));
+	reportMeasure(bench, numLinks, "heap_arity8_s", timeDijkstraWithArity<8>(graph, searchStarts));
+}
+
+int main(int argc, char * argv[]){
+	int numQueries = 1000;
+	int largestSize = 100000;
+	unsigned int seed = 1;
+	string resultsFileName = "benchmark_results.csv";
+	std::vector<benchmarkT> benches;
+	for(int i = 1; i < argc; i++){
+		string arg = argv[i];
+		if(arg == "-large"){
+			largestSize = 10000000;
+			continue;
+		}
+		if((arg == "-q" || arg == "-s" || arg == "-o") && i + 1 < argc){
+			string value = argv[++i];
+			if(arg == "-q") numQueries = atoi(value.c_str());
+			else if(arg == "-s") seed = atoi(value.c_str());
+			else resultsFileName = value;
+			continue;
+		}
+		benchmarkT bench;
+		string::size_type colon = arg.find(':');
+		if(colon == string::npos || !graphKindFromName(arg.substr(0, colon), bench.kind)
+			|| (bench.numPositions = atoi(arg.substr(colon + 1).c_str())) <= 0){
+			cout<<"Usage : benchmark [-q numQueries] [-s seed] [-o results.csv] [-large] [grid|geometric|road:size ...]"<<endl;
+			return 1;
+		}
+		benches.push_back(bench);
+	}
+	if(benches.empty()){
+		graphKindT kinds[] = {GRID_GRAPH, GEOMETRIC_GRAPH, ROAD_GRAPH};
+		for(int k = 0; k < 3; k++){
+			for(int size = 1000; size <= largestSize; size *= 10){
+				benchmarkT bench = {kinds[k], size};
+				benches.push_back(bench);
+			}
+		}
+	}
+	if(numQueries < 1) numQueries = 1;
+
+	resultsFile = fopen(resultsFileName.c_str(), "w");
+	if(resultsFile == NULL) cout<<"Can't write "<<resultsFileName<<", results go to the screen only"<<endl;
+	string header = "kind,positions,links,measure,value\n";
+	cout<<header;
+	if(resultsFile != NULL) fputs(header.c_str(), resultsFile);
+	for(int i = 0; i < (int)benches.size(); i++)
+		runBenchmark(benches[i], numQueries, seed);
+	if(resultsFile != NULL) fclose(resultsFile);
+	return 0;
+}
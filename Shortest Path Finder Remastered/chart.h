@@ -11,40 +11,87 @@
 #ifndef CHART_H
 #define CHART_H
 
-#include <cmath>
-#include <fstream>
+#include <vector>
 #include "map.h"
+#include "grid.h"
+#include "arena.h"
 #include "path.h"
 #include "position.h"
-#include "extgraph.h"
-#include "pqueuemin.h"
-#include "set.h"
+#include "chartrenderer.h"
+#include "chartbinary.h"
+#include "contractionhierarchy.h"
+#include "csrgraph.h"
+#include "distancematrix.h"
+#include "kshortestpaths.h"
+#include "nametable.h"
+#include "pathfinder.h"
+#include "searchtreecache.h"
+#include "searchstats.h"
+#include "stopwatch.h"
+#include "spanningtree.h"
+#include "spatialindex.h"
+
+const int NOT_FOUND = -1;
 
 /*
-* Type definitions 
-* -------------------
-* Some typedefs to increase readability of the code 
+* How a point to point query searches the chart
+* DIJKSTRA_SEARCH : spreads out from the start in every direction, the
+*                   searches of recent starts are kept and picked up
+*                   again by later queries from the same start
+* ASTAR_SEARCH    : heads for the end, guided by the straight line 
+*                   distance to it (the coordinates of the positions)
+* BIDIRECTIONAL_SEARCH : spreads out from the start and from the end
+*                   at once and stops where the two meet
+* HIERARCHY_SEARCH : climbs the contraction hierarchy of the chart from
+*                   both ends (see contractionhierarchy.h), the first
+*                   such query loads or builds the hierarchy
 */
-typedef Set<Position*> Branch;
-typedef Vector<Branch> Tree;
-
-/* Constants
- * ----------
- * A few program-wide constants concerning the graphical display.
- */
-const double CircleRadius =.05;       // The radius of a node
-const int LabelFontSize = 9;          // for node name labels
-const int NOT_FOUND = -1;
+enum searchModeT {DIJKSTRA_SEARCH, ASTAR_SEARCH, BIDIRECTIONAL_SEARCH, HIERARCHY_SEARCH};
 
-const string MAP_COLOR = "Gray";
-const string FINAL_PATH_COLOR = "Black";
-const string MST_COLOR = "Black";
+/*
+* How the minimal spanning tree is found, both find a tree of the same
+* (least) total cost
+* KRUSKAL_TREE : takes the links cheapest first, one at a time
+* BORUVKA_TREE : grows every part of the forest at once each round,
+*                using all the processors (see spanningtree.h)
+* FILTER_KRUSKAL_TREE : kruskal on a sorted copy of the links, dropping
+*                expensive links that would close a cycle before they
+*                are sorted, for charts with many more links than
+*                positions
+*/
+enum spanningTreeModeT {KRUSKAL_TREE, BORUVKA_TREE, FILTER_KRUSKAL_TREE};
+
+/*
+* What searchPathBetween hands back. The path is only meaningful when
+* the status is PATH_FOUND, otherwise it has no links and ends at the
+* start. numSettled counts the positions the search settled, stats has
+* the rest of the counters (see searchstats.h).
+*/
+struct pathSearchT{
+	searchStatusT status;
+	Path path;
+	int numSettled;
+	searchStatsT stats;
+};
+
+/*
+* What getReachableWithin hands back: every position that can be reached 
+* from the start for at most the budget, nearest first, and the cost of 
+* getting to each (costs[i] goes with positions[i]). links holds the 
+* links that can be crossed from end to end within the budget, e.g. to 
+* draw the area, and is only filled in when asked for.
+*/
+struct reachableT{
+	Vector<Position* > positions;
+	Vector<double> costs;
+	Vector<Link* > links;
+};
 
 class Chart{
 public : 
 	/*
 	* Function : Constructor function for the Chart class 
-	* Usage    : Chart myChart("DataFile.txt");
+	* Usage    : Chart myChart("DataFile.txt", &renderer);
 	* ----------------------------------------------------
 	* Constructor function for the Chart class, takes in the name 
 	* of data file that holds the data for nodes(Position(s)) and 
@@ -56,14 +103,22 @@ public :
 	* sampleNode 2.3(X coordinate) 4.2(Y coordinate)
 	* ...
 	* ARCS(Marks the begenning of connection between nodes)
-	* sampleNodeOne sampleNodeTwo 2000(cost of the connection)
+	* sampleNodeOne sampleNodeTwo 2000(cost of the connection, not negative)
 	* ...
+	* The chart is read from the compiled copy of the file (see 
+	* chartbinary.h) whenever that is up to date.
+	* The renderer is told about everything loaded and found, leave it 
+	* out to get a chart that never draws or pauses. treeCacheBytes caps 
+	* the memory taken by the search trees DIJKSTRA_SEARCH keeps for the 
+	* starts used last (see searchtreecache.h), 0 turns that cache off.
 	*/
-	Chart(string dataFileName);
+	Chart(string dataFileName, ChartRenderer * chartRenderer = NULL, long treeCacheBytes = DEFAULT_TREE_CACHE_BYTES);
 
 	/*
 	* Function : Destructor function for the Chart class
 	* ---------------------------------------------------
+	* Frees every position and link of the chart, pointers to them 
+	* handed out before (in paths, or to the renderer) go with it.
 	*/
 	~Chart();
 	
@@ -76,124 +131,353 @@ public :
 	*/
 	string getPositionNameAt(coordT posCoords);
 
+	/*
+	* Function : getNearestPositionName
+	* Usage    : string posName = myChart.getNearestPositionName(coords, maxDistance);
+	* ------------------------------------------------------------------------------
+	* Snaps the coordinates to the nearest position on the chart and returns 
+	* its name, or an empty string if no position lies within maxDistance.
+	* Leave out maxDistance to always get the nearest position.
+	*/
+	string getNearestPositionName(coordT posCoords, double maxDistance = -1);
+
+	/*
+	* Function : getPositionNamesWithin
+	* Usage    : Vector<string> names = myChart.getPositionNamesWithin(coords, radius);
+	* -------------------------------------------------------------------------------
+	* Returns the names of all the positions at most radius away from the 
+	* given coordinates.
+	*/
+	Vector<string> getPositionNamesWithin(coordT posCoords, double radius);
+
 	/*
 	* Function : findShortestPathBetween
 	* Usage    : findShortesPathBetween(startPositionName, endPositionName)
 	* ---------------------------------------------------------------------
 	* Takes in the names of the starting and the ending positions on the 
-	* chart and finds the shortest path between the positions marked by 
-	* highlighting the path on the chart in the display window
+	* chart and finds the shortest path between the positions, then hands 
+	* the path to the renderer to be highlighted. Every search mode finds 
+	* a path of the same (least) cost, they differ only in how much of 
+	* the chart they look at on the way.
+	*/
+	void findShortestPathBetween(string startPosName, string endPosName, searchModeT mode = DIJKSTRA_SEARCH);
+
+	/*
+	* Function : getShortestPathBetween
+	* Usage    : Path path = myChart.getShortestPathBetween(startPositionName, endPositionName);
+	* ----------------------------------------------------------------------------------------
+	* Same search as findShortestPathBetween but hands the path back instead 
+	* of drawing it. If the end can't be reached from the start the returned 
+	* path has no links and ends at the start position.
+	*/
+	Path getShortestPathBetween(string startPosName, string endPosName, searchModeT mode = DIJKSTRA_SEARCH);
+
+	/*
+	* Function : searchPathBetween
+	* Usage    : pathSearchT result = myChart.searchPathBetween(startName, endName, limits);
+	* ----------------------------------------------------------------------------------
+	* Same search as getShortestPathBetween with DIJKSTRA_SEARCH, cut off 
+	* once any of the budgets in limits runs out (see searchLimitsT in 
+	* pathfinder.h). The result says whether a path was found and, if 
+	* not, whether the end is unreachable or which budget ran out.
+	*/
+	pathSearchT searchPathBetween(string startPosName, string endPosName, searchLimitsT limits = NO_SEARCH_LIMITS);
+
+	/*
+	* Function : getShortestPathsBetween
+	* Usage    : Vector<Path> routes = myChart.getShortestPathsBetween(startPositionName, endPositionName, 3);
+	* ------------------------------------------------------------------------------------------------
+	* Returns up to numPaths different paths from the start to the end, 
+	* cheapest first, the first of them a shortest path, to offer as 
+	* alternative routes. No path passes the same position twice (see 
+	* kshortestpaths.h). Fewer paths come back if the chart doesn't have 
+	* that many, none if the end can't be reached. Nothing is drawn.
+	*/
+	Vector<Path> getShortestPathsBetween(string startPosName, string endPosName, int numPaths);
+
+	/*
+	* Function : findReachableWithin
+	* Usage    : myChart.findReachableWithin(startPositionName, maxCost);
+	* ---------------------------------------------------------------
+	* Finds the part of the chart that can be reached from the start for 
+	* at most maxCost and hands every link that can be crossed from end 
+	* to end within it to the renderer.
+	*/
+	void findReachableWithin(string startPosName, double maxCost);
+
+	/*
+	* Function : getReachableWithin
+	* Usage    : reachableT area = myChart.getReachableWithin(startPositionName, maxCost, true);
+	* ------------------------------------------------------------------------------------
+	* Same search as findReachableWithin but hands the positions reached, 
+	* their costs and, if withLinks is true, the links back instead of 
+	* drawing anything (see reachableT). One search answers it, taking 
+	* time in proportion to the part of the chart within reach.
 	*/
-	void findShortestPathBetween(string startPosName, string endPosName);
+	reachableT getReachableWithin(string startPosName, double maxCost, bool withLinks = false);
+
+	/*
+	* Function : getDistanceMatrix
+	* Usage    : Grid<double> costs = myChart.getDistanceMatrix(sourceNames, targetNames);
+	* -------------------------------------------------------------------------------
+	* Returns a grid with a row for every source and a column for every 
+	* target holding the cost of the cheapest path between the two, 
+	* INFINITE_DISTANCE where there is none. Nothing is drawn. The 
+	* searches from the different sources run in parallel.
+	*/
+	Grid<double> getDistanceMatrix(Vector<string> sourceNames, Vector<string> targetNames);
 	
 	/*
 	* Function : findMinimalSpanningTree
 	* Usage    : myChart.findMinimalTree();
 	* -------------------------------------------
 	* Finds the minimal spanning tree in the current graph
-	* by using kruskal's algorithm.
+	* by using kruskal's algorithm (or the one mode says) and 
+	* hands every link of it to the renderer.
+	*/
+	void findMinimalSpanningTree(spanningTreeModeT mode = KRUSKAL_TREE);
+
+	/*
+	* Function : getMinimalSpanningTree
+	* Usage    : Vector<Link* > treeLinks = myChart.getMinimalSpanningTree(BORUVKA_TREE);
+	* ------------------------------------------------------------------------------
+	* Same as findMinimalSpanningTree but hands the links of the tree back 
+	* instead of drawing them. If the chart falls apart in several pieces 
+	* the links span every piece on its own.
+	*/
+	Vector<Link* > getMinimalSpanningTree(spanningTreeModeT mode = KRUSKAL_TREE);
+
+	/*
+	* Function : getLinkBetween
+	* Usage    : Link * road = myChart.getLinkBetween(startPositionName, endPositionName);
+	* --------------------------------------------------------------------------------
+	* Returns the cheapest link joining the two positions, or NULL if no 
+	* link joins them.
+	*/
+	Link * getLinkBetween(string startPosName, string endPosName);
+
+	/*
+	* Function : setLinkCost, addLinkBetween, removeLink
+	* Usage    : myChart.setLinkCost(road, newCost);
+	*            Link * road = myChart.addLinkBetween(startPositionName, endPositionName, cost);
+	*            myChart.removeLink(road);
+	* ------------------------------------------------------------------------------------
+	* Change the links of the loaded chart, to follow traffic or close a 
+	* road, without reading the data file again. Every query made after a 
+	* change sees it. The cached search trees are repaired rather than 
+	* thrown away and the contraction hierarchy is built again on the next 
+	* HIERARCHY_SEARCH. Nothing is written back to the data file, the 
+	* compiled chart or the saved hierarchy. A removed link stays valid 
+	* in paths found before, it is just no longer one of the links of its 
+	* positions, and can't be given a cost again. A new link is handed to 
+	* the renderer as the loaded ones were.
+	*/
+	void setLinkCost(Link * link, double cost);
+	Link * addLinkBetween(string startPosName, string endPosName, double cost);
+	void removeLink(Link * link);
+
+	/*
+	* Function : getLastQueryStats, getTotalStats, clearStats
+	* Usage    : searchStatsT stats = myChart.getLastQueryStats();
+	* -------------------------------------------------------------
+	* What the last path search, distance matrix or spanning tree did, 
+	* and all of them added up since the chart was loaded or clearStats 
+	* was last called. Counting only happens when the program is compiled 
+	* with COLLECT_SEARCH_STATS (see searchstats.h), otherwise every 
+	* counter stays zero.
 	*/
-	void findMinimalSpanningTree();
+	searchStatsT getLastQueryStats();
+	searchStatsT getTotalStats();
+	void clearStats();
 
 private :
-	Map<Position* > positions;
-	Vector<Link* > links;
-	ifstream infile;
+	/*
+	* The positions and links themselves live in the arenas, created in 
+	* file order, one block each. The links starting or ending at every 
+	* position are kept in originatingLinks in the order of the graph's 
+	* edges, each position points at its own stretch of it.
+	*/
+	Arena<Position> positionArena;
+	Arena<Link> linkArena;
+	vector<Position* > positionsById;
+	vector<Link* > links;
+	vector<Link* > originatingLinks;
+	ChartRenderer * renderer;
 
-	void addPositionsFromData(ifstream &infile);
-	void addLinksFromData(ifstream &infile);
-	void addPosition(string posName, double x, double y);
-	void addLink(string startPosName, string endPosName, double cost);
+	void addFromData(ChartData &data);
+	void addPosition(const char * posName, coordT posCoords);
+	void addLink(Position * start, Position * end, double cost);
 
 	Position * getPosition(string posName);
+
+	/*
+	* The names of the positions, the id of a name is the id of its 
+	* position. Names are only looked up here when they come in through 
+	* the interface, everything past that works with ids.
+	*/
+	NameTable positionNames;
 	
-	void drawFilledCircleWithLabel(coordT center, string color, string label = "");
-	void drawLineBetween(coordT start, coordT end, string color = "Black");
-	bool withinDistance(coordT pt1, coordT pt2, double maxDistance = CircleRadius*2);
-	void colorPath(Path &path, string color);
-
-	static int cmpPaths(Path p1, Path p2);
-	static int cmpLinks(Link* l1, Link* l2);
-	void recFindShortestPath(Path &currentPath, PQueue<Path> &paths, Set<string> &visited, Position * end);
-	
-	int getContainingBranch(Position * pos, Tree &tree);
-	bool includeInTree(Position * start, Position * end,Tree &tree );
-};
+	/*
+	* Coordinates of the positions indexed by position id, and a grid over 
+	* them used to answer coordinate lookups. Built once loading is done.
+	*/
+	vector<coordT> positionCoords;
+	SpatialIndex spatialIndex;
 
-#endif
+	/*
+	* The positions and links in compressed sparse row form, built once 
+	* loading is done and changed along with the links after that. 
+	* Searches and the spanning tree run on it, link ids in it are indexes 
+	* into links.
+	*/
+	CSRGraph graph;
+	PathFinder pathFinder;
+	SearchTreeCache treeCache;
+	DistanceMatrix distanceMatrix;
+	KShortestPaths kShortestPaths;
+
+	/*
+	* Shortcuts over the graph for HIERARCHY_SEARCH, prepared on first
+	* use and kept in a file next to the data file.
+	*/
+	string chartFileName;
+	ContractionHierarchy hierarchy;
+	bool linksChanged;               // the links no longer match the data file
+
+	double heuristicScale;
+
+	searchStatsT lastQueryStats;
+	searchStatsT totalStats;
+
+	void buildGraph(ChartData &data);
+	void linkPositions();
+	void linkPosition(int posId);
+	void relinkEnds(int linkId);
+	void linkChanged(int linkId, double oldCost, double newCost);
+	void prepareHierarchy();
+	bool findPathLinks(int start, int end, searchModeT mode, vector<int> &linkIds);
+	void finishQueryStats(searchStatsT queryStats, double searchSeconds, double pathSeconds);
+	void buildSpatialIndex();
+	Path buildPath(Position * start, const vector<int> &linkIds);
+};
 
-Chart::Chart(string dataFileName){
-	infile.open(dataFileName.c_str());
-	// The first line in the data file is the name of the image file 
-	string imageFileName;
-	infile>>imageFileName;
-	SetWindowTitle("Shortest path finder/Nash Vail");
-	DrawNamedPicture(imageFileName);
-	// Next line says NODES which mark the beginning of the nodes 
-	infile>>imageFileName;
-	addPositionsFromData(infile);
-	addLinksFromData(infile);
-	infile.close();
+Chart::Chart(string dataFileName, ChartRenderer * chartRenderer, long treeCacheBytes) : treeCache(treeCacheBytes){
+	renderer = chartRenderer;
+	chartFileName = dataFileName;
+	linksChanged = false;
+	lastQueryStats = totalStats = NO_SEARCH_STATS;
+	ChartData data;
+	loadChartData(dataFileName, data);
+	addFromData(data);
+	buildGraph(data);
+	linkPositions();
+	buildSpatialIndex();
 
 };
 
 
+// The arenas destroy the positions and links and free their blocks on their own
 Chart::~Chart(){
 	
 };
 
-void Chart::addPosition(string posName, double x, double y){
-	coordT posCoords = {x, y};
-	Position* pos = new Position(posName, posCoords);
-	positions.add(posName, pos);
+// Links were created in data order, so link ids in the data match indexes into links
+void Chart::buildGraph(ChartData &data){
+	if(data.edgeOffsets.empty()){
+		graph.build(positionsById.size(), data.linkStarts, data.linkEnds, data.linkCosts);
+	}else{
+		graph.assign(positionsById.size(), data.linkStarts, data.linkEnds, data.linkCosts,
+			data.edgeOffsets, data.edgeTargets, data.edgeLinks);
+	}
+	pathFinder.setGraph(&graph);
+	treeCache.setGraph(&graph);
+	distanceMatrix.setGraph(&graph);
+	kShortestPaths.setGraph(&graph);
+}
 
-	// Draw the position in the graphics window
-	drawFilledCircleWithLabel(posCoords, MAP_COLOR, posName);
+// Points every position at the links of its edges in the graph, originatingLinks is indexed by edge
+void Chart::linkPositions(){
+	originatingLinks.resize(graph.numEdgeSlots());
+	for(int node = 0; node < (int)positionsById.size(); node++)
+		linkPosition(node);
 }
 
-void Chart::addLink(string startPosName, string endPosName, double cost){
-	Position * start = getPosition(startPosName);
-	Position * end = getPosition(endPosName);
-	
-	Link* posLink = new Link(start, end, cost);
-	links.add(posLink);
+void Chart::linkPosition(int posId){
+	int first = graph.firstEdge(posId), last = graph.endEdge(posId);
+	for(int edge = first; edge < last; edge++)
+		originatingLinks[edge] = links[graph.getLinkId(edge)];
+	Link * const * firstLink = originatingLinks.empty() ? NULL : &originatingLinks[0] + first;
+	positionsById[posId]->setOriginatingLinks(firstLink, last - first);
+}
 
-	// Draw the link between positions in the graphics window
-	drawLineBetween(start->getCoordinates(), end->getCoordinates(), MAP_COLOR);
+// After the graph changed the edges of a link's ends, all positions if originatingLinks moved
+void Chart::relinkEnds(int linkId){
+	Link * const * before = originatingLinks.empty() ? NULL : &originatingLinks[0];
+	originatingLinks.resize(graph.numEdgeSlots());
+	Link * const * after = originatingLinks.empty() ? NULL : &originatingLinks[0];
+	if(after != before){
+		linkPositions();
+		return;
+	}
+	linkPosition(graph.getLinkStart(linkId));
+	linkPosition(graph.getLinkEnd(linkId));
+}
 
-	start->addOriginatingLink(posLink);
-	end->addOriginatingLink(posLink);
+// Loads the saved hierarchy if it still fits the chart, otherwise builds and saves it
+void Chart::prepareHierarchy(){
+	if(hierarchy.isBuilt()) return;
+	if(linksChanged){
+		// The saved hierarchy is that of the data file
+		hierarchy.build(graph);
+		return;
+	}
+	string fileName = hierarchyFileName(chartFileName);
+	if(hierarchy.load(fileName, chartFileName, graph)) return;
+	hierarchy.build(graph);
+	hierarchy.save(fileName, chartFileName);
+}
 
+void Chart::buildSpatialIndex(){
+	positionCoords.resize(positionsById.size());
+	for(int i = 0; i < (int)positionsById.size(); i++)
+		positionCoords[i] = positionsById[i]->getCoordinates();
+	spatialIndex.build(positionCoords);
+	heuristicScale = calibrateHeuristicScale(graph, positionCoords);
+	pathFinder.setHeuristic(&positionCoords, heuristicScale);
 }
 
-void Chart::addPositionsFromData(ifstream &infile){
-	string posName; 
-	double x,y;
-	while(true){
-		infile>>posName;
-		if(posName == "ARCS") break;
-		infile>>x;
-		infile>>y;
-		addPosition(posName, x, y);
-	}
+// Creates the positions and links described by the data, in file order, the names are moved out of it
+void Chart::addFromData(ChartData &data){
+	if(renderer != NULL) renderer->chartOpened(data.imageFileName);
+	positionNames.swap(data.names);
+	positionArena.reserve(positionNames.size());
+	positionsById.reserve(positionNames.size());
+	linkArena.reserve(data.numLinks());
+	links.reserve(data.numLinks());
+	for(int i = 0; i < positionNames.size(); i++)
+		addPosition(positionNames.getName(i), data.coords[i]);
+	for(int i = 0; i < data.numLinks(); i++)
+		addLink(positionsById[data.linkStarts[i]], positionsById[data.linkEnds[i]], data.linkCosts[i]);
 }
 
-void Chart::addLinksFromData(ifstream &infile){
-	string startPosName, endPosName;
-	double cost;
-	while(true){
-		infile>>startPosName;
-		infile>>endPosName;
-		infile>>cost;
-		if(infile.eof()) break;
-		addLink(startPosName, endPosName, cost);
-	}
+void Chart::addPosition(const char * posName, coordT posCoords){
+	Position* pos = positionArena.create(Position(posName, posCoords, positionsById.size()));
+	positionsById.push_back(pos);
+
+	if(renderer != NULL) renderer->positionAdded(pos);
 }
 
+void Chart::addLink(Position * start, Position * end, double cost){
+	Link* posLink = linkArena.create(Link(start, end, cost, links.size()));
+	links.push_back(posLink);
 
+	if(renderer != NULL) renderer->linkAdded(posLink);
+
+}
 
 Position* Chart::getPosition(string posName){
-	if(positions.containsKey(posName)) return positions.getValue(posName);
+	int posId = positionNames.find(posName);
+	if(posId != -1) return positionsById[posId];
 	else{
 		Error("No position with that name found");
 		return NULL;
@@ -201,170 +485,258 @@ Position* Chart::getPosition(string posName){
 }
 
 
+// A click counts if it lands within a node diameter of a position
 string Chart::getPositionNameAt(coordT posCoords){
-	Map<Position* >::Iterator posItr = positions.iterator();
-	while(posItr.hasNext()){
-		string posName = posItr.next();
-		Position * pos = getPosition(posName);
-		if(withinDistance(posCoords, pos->getCoordinates())) return posName;
-	}
-	return "";
-
-}
-
-/* Function: DrawFilledCircleWithLabel
- * Usage:  DrawFilledCircleWithLabel(center, "Green", "You are here");
- * -------------------------------------------------------------------
- * Uses facilities from extgraph to draw a circle filled with
- * color specified. The circle is centered at the given coord has the
- * specified radius.  A label is drawn to the right of the circle.
- * You can leave off the last argument if no label is desired.
- */
-void Chart::drawFilledCircleWithLabel(coordT center, string color, string label){
-	MovePen(center.x + CircleRadius, center.y);
-	SetPenColor(color);
-	StartFilledRegion(1.0);
-	DrawArc(CircleRadius, 0, 360);
-	EndFilledRegion();
-	if (!label.empty()) {
-		MovePen(center.x + CircleRadius, center.y);
-		SetFont("Helvetica");
-		SetPointSize(LabelFontSize);
-		DrawTextString(label);
-	}
+	return getNearestPositionName(posCoords, CircleRadius*2);
 }
 
-/* Function: DrawLineBetween
- * Usage:  DrawLineBetween(coord1, coord2, "Black");
- * -------------------------------------------------
- * Uses facilities from extgraph to draw a line of the
- * specified color between the two given coordinates.
- */
-void Chart::drawLineBetween(coordT start, coordT end, string color)
-{
-	SetPenColor(color);
-	MovePen(start.x, start.y);
-	DrawLine(end.x - start.x, end.y - start.y);
-}
-
-/* Function: WithinDistance
- * Usage:  if (WithinDistance(click, pt))...
- * -----------------------------------------
- * Returns true if the Cartesian distance between the two coordinates
- * is <= the specified distance, false otherwise. If not specified,
- * the distance is assumed to be size of the node diameter on screen.
- */
-bool Chart::withinDistance(coordT pt1, coordT pt2, double maxDistance){
-	double dx = pt2.x - pt1.x;
-	double dy = pt2.y - pt1.y;
-	double distance = sqrt(dx*dx + dy*dy);
-	return (distance <= maxDistance);
-}
-
-
-// Acts as wrapper function for the recFindShortestPath function
-void Chart::findShortestPathBetween(string startPosName, string endPosName){
+string Chart::getNearestPositionName(coordT posCoords, double maxDistance){
+	int posId = spatialIndex.findNearest(posCoords, maxDistance);
+	if(posId == -1) return "";
+	return positionsById[posId]->getName();
+}
+
+Vector<string> Chart::getPositionNamesWithin(coordT posCoords, double radius){
+	vector<int> posIds;
+	spatialIndex.findWithin(posCoords, radius, posIds);
+	Vector<string> posNames;
+	for(int i = 0; i < (int)posIds.size(); i++)
+		posNames.add(positionsById[posIds[i]]->getName());
+	return posNames;
+}
+
+// Acts as wrapper function for the getShortestPathBetween function
+void Chart::findShortestPathBetween(string startPosName, string endPosName, searchModeT mode){
+	Path path = getShortestPathBetween(startPosName, endPosName, mode);
+	if(renderer != NULL) renderer->pathFound(path);
+}
+
+Path Chart::getShortestPathBetween(string startPosName, string endPosName, searchModeT mode){
 	Position * start = getPosition(startPosName);
-	Path path(start);
-	PQueue<Path> paths(cmpPaths);
-	paths.enqueue(path);
-	Set<string> visitedPosNames;
 	Position * end = getPosition(endPosName);
-
-	recFindShortestPath(path, paths, visitedPosNames, end);
+	COUNT_STAT(Stopwatch watch);
+	vector<int> linkIds;
+	bool found = findPathLinks(start->getId(), end->getId(), mode, linkIds);
+	COUNT_STAT(double searchSeconds = watch.getSeconds());
+	COUNT_STAT(watch.restart());
+	Path path = found ? buildPath(start, linkIds) : Path(start);
+	COUNT_STAT(finishQueryStats(lastQueryStats, searchSeconds, watch.getSeconds()));
+	return path;
 }
 
-void Chart::recFindShortestPath(Path &currentPath, PQueue<Path> &paths, Set<string> &visited, Position * end){
-	Position * currentPos = currentPath.getEndPosition();
-	if(currentPos == end){
-		colorPath(currentPath, FINAL_PATH_COLOR);
-		return;
-	}
-	visited.add(currentPos->getName());
-	Vector<Link *> * neighborLinks = currentPos->getOriginatingLinks();
-	for(int i = 0; i < neighborLinks->size(); i++){
-		Position * neighbor = neighborLinks->getAt(i)->getOtherEnd(currentPos);
-		if(!visited.contains(neighbor->getName())){
-			currentPath.addLinkToPath(neighborLinks->getAt(i));
-			paths.enqueue(currentPath);
-			currentPath.popLinkFromPath();
+// Runs the search of the given mode and fills linkIds with the links of the path found
+bool Chart::findPathLinks(int start, int end, searchModeT mode, vector<int> &linkIds){
+	bool found;
+	switch(mode){
+	case ASTAR_SEARCH:
+		found = pathFinder.findShortestPathAStar(start, end);
+		break;
+	case BIDIRECTIONAL_SEARCH:
+		found = pathFinder.findShortestPathBidirectional(start, end);
+		break;
+	case HIERARCHY_SEARCH:
+		prepareHierarchy();
+		found = hierarchy.findShortestPath(start, end);
+		if(found) hierarchy.getPathLinks(linkIds);
+		COUNT_STAT(lastQueryStats = hierarchy.getStats());
+		return found;
+	default:
+		if(treeCache.getCapacity() == 0){
+			found = pathFinder.findShortestPath(start, end);
+			break;
 		}
+		found = treeCache.findShortestPath(start, end, linkIds);
+		COUNT_STAT(lastQueryStats = treeCache.getStats());
+		return found;
 	}
+	if(found) pathFinder.getPathLinks(end, linkIds);
+	COUNT_STAT(lastQueryStats = pathFinder.getStats());
+	return found;
+}
 
-	recFindShortestPath(paths.dequeueMin(), paths, visited, end);
-	
+// Fills in the times of the query that just ended and adds it to the totals
+void Chart::finishQueryStats(searchStatsT queryStats, double searchSeconds, double pathSeconds){
+	lastQueryStats = queryStats;
+	lastQueryStats.searchSeconds = searchSeconds - queryStats.setupSeconds;
+	lastQueryStats.pathSeconds = pathSeconds;
+	addStats(totalStats, lastQueryStats);
+}
+
+searchStatsT Chart::getLastQueryStats(){
+	return lastQueryStats;
 }
 
-int Chart::cmpPaths(Path p1, Path p2){
-	if(p1.getTotalPathCost() < p2.getTotalPathCost()) return -1;
-	else if(p1.getTotalPathCost() > p2.getTotalPathCost()) return 1;
-	else return 0;
+searchStatsT Chart::getTotalStats(){
+	return totalStats;
 }
 
-int Chart::cmpLinks(Link *l1, Link *l2){
-	if(l1->getCost() > l2->getCost()) return 1;
-	else if(l1->getCost() < l2->getCost()) return -1;
-	else return 0;
+void Chart::clearStats(){
+	lastQueryStats = totalStats = NO_SEARCH_STATS;
 }
 
-void Chart::colorPath(Path &path, string color){
-	for(int i = 0 ; i < path.lengthInLinks(); i++){
-		Position * start = path.getAt(i)->getStart();
-		Position * end = path.getAt(i)->getEnd();
-		drawLineBetween(start->getCoordinates(), end->getCoordinates(), color);
-		drawFilledCircleWithLabel(start->getCoordinates(), color, start->getName());
-		drawFilledCircleWithLabel(end->getCoordinates(), color, end->getName());
-		Pause(0.15);
+pathSearchT Chart::searchPathBetween(string startPosName, string endPosName, searchLimitsT limits){
+	Position * start = getPosition(startPosName);
+	Position * end = getPosition(endPosName);
+	COUNT_STAT(Stopwatch watch);
+	pathSearchT result;
+	result.status = pathFinder.findShortestPathWithin(start->getId(), end->getId(), limits);
+	result.numSettled = pathFinder.getNumSettled();
+	vector<int> linkIds;
+	if(result.status == PATH_FOUND) pathFinder.getPathLinks(end->getId(), linkIds);
+	COUNT_STAT(double searchSeconds = watch.getSeconds());
+	COUNT_STAT(watch.restart());
+	result.path = (result.status == PATH_FOUND) ? buildPath(start, linkIds) : Path(start);
+	COUNT_STAT(finishQueryStats(pathFinder.getStats(), searchSeconds, watch.getSeconds()));
+	result.stats = lastQueryStats;
+	return result;
+}
+
+Vector<Path> Chart::getShortestPathsBetween(string startPosName, string endPosName, int numPaths){
+	Position * start = getPosition(startPosName);
+	Position * end = getPosition(endPosName);
+	COUNT_STAT(Stopwatch watch);
+	int numFound = kShortestPaths.findPaths(start->getId(), end->getId(), numPaths);
+	COUNT_STAT(double searchSeconds = watch.getSeconds());
+	COUNT_STAT(watch.restart());
+	Vector<Path> paths;
+	vector<int> linkIds;
+	for(int i = 0; i < numFound; i++){
+		kShortestPaths.getPathLinks(i, linkIds);
+		paths.add(buildPath(start, linkIds));
 	}
+	COUNT_STAT(finishQueryStats(kShortestPaths.getStats(), searchSeconds, watch.getSeconds()));
+	return paths;
 }
 
-void Chart::findMinimalSpanningTree(){
-	// Refer typedefs defined
-	PQueue<Link*> chartLinks(cmpLinks);
-	for(int i = 0 ; i < links.size(); i++)
-		chartLinks.enqueue(links[i]);
-	
-	Tree minimalSpanTree;
-	while(!chartLinks.isEmpty()){
-		Link * currentLink = chartLinks.dequeueMin();
-		Position * start = currentLink->getStart();
-		Position * end = currentLink->getEnd();
-		
-		if(includeInTree(start, end, minimalSpanTree)){
-			Pause(0.01);
-			drawLineBetween(start->getCoordinates(), end->getCoordinates(), MST_COLOR);
-			drawFilledCircleWithLabel(start->getCoordinates(), MST_COLOR, start->getName());
-			drawFilledCircleWithLabel(end->getCoordinates(), MST_COLOR, end->getName());
-		}
+void Chart::findReachableWithin(string startPosName, double maxCost){
+	reachableT area = getReachableWithin(startPosName, maxCost, renderer != NULL);
+	if(renderer == NULL) return;
+	for(int i = 0; i < area.links.size(); i++)
+		renderer->reachableLinkFound(area.links[i]);
+}
+
+reachableT Chart::getReachableWithin(string startPosName, double maxCost, bool withLinks){
+	Position * start = getPosition(startPosName);
+	COUNT_STAT(Stopwatch watch);
+	vector<int> posIds, linkIds;
+	pathFinder.findReachableWithin(start->getId(), maxCost, posIds, withLinks ? &linkIds : NULL);
+	COUNT_STAT(double searchSeconds = watch.getSeconds());
+	COUNT_STAT(watch.restart());
+	reachableT area;
+	for(int i = 0; i < (int)posIds.size(); i++){
+		area.positions.add(positionsById[posIds[i]]);
+		area.costs.add(pathFinder.getDistance(posIds[i]));
 	}
+	for(int i = 0; i < (int)linkIds.size(); i++)
+		area.links.add(links[linkIds[i]]);
+	COUNT_STAT(finishQueryStats(pathFinder.getStats(), searchSeconds, watch.getSeconds()));
+	return area;
+}
+
+Grid<double> Chart::getDistanceMatrix(Vector<string> sourceNames, Vector<string> targetNames){
+	vector<int> sourceIds, targetIds;
+	for(int i = 0; i < sourceNames.size(); i++)
+		sourceIds.push_back(getPosition(sourceNames[i])->getId());
+	for(int i = 0; i < targetNames.size(); i++)
+		targetIds.push_back(getPosition(targetNames[i])->getId());
+
+	COUNT_STAT(Stopwatch watch);
+	vector<double> costs;
+	distanceMatrix.compute(sourceIds, targetIds, costs);
+	COUNT_STAT(finishQueryStats(distanceMatrix.getStats(), watch.getSeconds(), 0));
+	Grid<double> matrix(sourceIds.size(), targetIds.size());
+	for(int i = 0; i < (int)sourceIds.size(); i++)
+		for(int j = 0; j < (int)targetIds.size(); j++)
+			matrix.setAt(i, j, costs[i * targetIds.size() + j]);
+	return matrix;
+}
+
+// Replays the links with the given ids one after the other from start
+Path Chart::buildPath(Position * start, const vector<int> &linkIds){
+	Path path(start);
+	for(int i = 0; i < (int)linkIds.size(); i++)
+		path.addLinkToPath(links[linkIds[i]]);
+	return path;
+}
+
+void Chart::findMinimalSpanningTree(spanningTreeModeT mode){
+	Vector<Link* > treeLinks = getMinimalSpanningTree(mode);
+	if(renderer == NULL) return;
+	for(int i = 0; i < treeLinks.size(); i++)
+		renderer->spanningTreeLinkFound(treeLinks[i]);
 }
 
-bool Chart::includeInTree(Position * start, Position * end, Tree &minimalSpanTree){
-	int brnchCntngStart = getContainingBranch(start, minimalSpanTree);
-	int brnchCntngEnd = getContainingBranch(end, minimalSpanTree);
-		
-	if(brnchCntngStart != brnchCntngEnd && (brnchCntngStart != NOT_FOUND && brnchCntngEnd != NOT_FOUND)){
-		minimalSpanTree[brnchCntngStart].unionWith(minimalSpanTree[brnchCntngEnd]);
-		minimalSpanTree.removeAt(brnchCntngEnd);
-		return true;
-	}else if(brnchCntngStart == NOT_FOUND && brnchCntngEnd == NOT_FOUND){
-		Branch newBranch;
-		newBranch.add(start);
-		newBranch.add(end);
-		minimalSpanTree.add(newBranch);
-		return true;
-	}else if (brnchCntngStart == NOT_FOUND || brnchCntngEnd == NOT_FOUND){
-		int validBranch = (brnchCntngStart != NOT_FOUND) ? brnchCntngStart : brnchCntngEnd;
-		minimalSpanTree[validBranch].add(start);
-		minimalSpanTree[validBranch].add(end);
-		return true;
+Vector<Link* > Chart::getMinimalSpanningTree(spanningTreeModeT mode){
+	COUNT_STAT(Stopwatch watch);
+	searchStatsT treeStats = NO_SEARCH_STATS;
+	vector<int> treeLinkIds;
+	if(mode == BORUVKA_TREE) boruvkaSpanningTree(graph, treeLinkIds, &treeStats);
+	else if(mode == FILTER_KRUSKAL_TREE) filterKruskalSpanningTree(graph, treeLinkIds, &treeStats);
+	else kruskalSpanningTree(graph, treeLinkIds, &treeStats);
+	COUNT_STAT(finishQueryStats(treeStats, watch.getSeconds(), 0));
+	Vector<Link* > treeLinks;
+	for(int i = 0; i < (int)treeLinkIds.size(); i++)
+		treeLinks.add(links[treeLinkIds[i]]);
+	return treeLinks;
+}
+
+Link * Chart::getLinkBetween(string startPosName, string endPosName){
+	Position * start = getPosition(startPosName);
+	Position * end = getPosition(endPosName);
+	Link * cheapest = NULL;
+	for(int i = 0; i < start->numOriginatingLinks(); i++){
+		Link * link = start->getOriginatingLink(i);
+		if(link->getOtherEnd(start) != end) continue;
+		if(cheapest == NULL || link->getCost() < cheapest->getCost()) cheapest = link;
 	}
+	return cheapest;
+}
+
+void Chart::setLinkCost(Link * link, double cost){
+	if(graph.isLinkRemoved(link->getId())) Error("The link was removed from the chart");
+	if(cost < 0) Error("Link costs can't be negative");
+	double oldCost = link->getCost();
+	link->setCost(cost);
+	graph.setLinkCost(link->getId(), cost);
+	linkChanged(link->getId(), oldCost, cost);
+}
+
+// The graph hands out the same id the link gets in links
+Link * Chart::addLinkBetween(string startPosName, string endPosName, double cost){
+	Position * start = getPosition(startPosName);
+	Position * end = getPosition(endPosName);
+	if(cost < 0) Error("Link costs can't be negative");
+	int linkId = graph.addLink(start->getId(), end->getId(), cost);
+	addLink(start, end, cost);
+	relinkEnds(linkId);
+	linkChanged(linkId, INFINITE_DISTANCE, cost);
+	return links[linkId];
+}
+
+void Chart::removeLink(Link * link){
+	int linkId = link->getId();
+	if(graph.isLinkRemoved(linkId)) return;
+	graph.removeLink(linkId);
+	relinkEnds(linkId);
+	linkChanged(linkId, link->getCost(), INFINITE_DISTANCE);
+}
 
-	return false;
+/*
+* Brings everything worked out from the graph in line with a change to
+* one link. A* only needs its estimate lowered when a link gets cheaper
+* per unit of length than any before, see calibrateHeuristicScale.
+*/
+void Chart::linkChanged(int linkId, double oldCost, double newCost){
+	linksChanged = true;
+	treeCache.repair(linkId, oldCost, newCost);
+	if(hierarchy.isBuilt()) hierarchy = ContractionHierarchy();
+	if(newCost >= oldCost || heuristicScale == 0) return;
+	coordT start = positionCoords[graph.getLinkStart(linkId)];
+	coordT end = positionCoords[graph.getLinkEnd(linkId)];
+	double length = sqrt((end.x - start.x)*(end.x - start.x) + (end.y - start.y)*(end.y - start.y));
+	if(length == 0 || newCost / length * (1 - 1e-9) >= heuristicScale) return;
+	heuristicScale = (newCost > 0) ? newCost / length * (1 - 1e-9) : 0;
+	pathFinder.setHeuristic(&positionCoords, heuristicScale);
 }
 
-int Chart::getContainingBranch(Position * pos, Tree &minimalSpanTree ){
-	for(int i = 0 ; i < minimalSpanTree.size() ; i++)
-		if(minimalSpanTree[i].contains(pos)) return i;
-	return NOT_FOUND;
-}
\ No newline at end of file
+#endif
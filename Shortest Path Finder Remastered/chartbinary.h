@@ -0,0 +1,260 @@
+/*
+* File : chartbinary.h
+* ---------------------
+* Reading and writing of compiled charts. A compiled chart is a binary
+* copy of a text data file (see chart.h for that format) that holds the
+* same ChartData, names interned into one block, coordinates, links and
+* the compressed sparse row adjacency, laid out so that it can be memory
+* mapped and copied out array by array with no per element work.
+*
+* The text file stays the source of truth. The compiled file records the
+* size and modification time of the text file it was made from, and
+* loadChartData only uses it while those still match, otherwise it parses
+* the text and writes a fresh compiled file next to it (the text file
+* name with ".bin" added, e.g. USA.txt.bin).
+*
+* ****************Compiled Chart Format******************
+* header (compiledChartHeaderT, see below)
+* coords        numPositions  x (double x, double y)
+* linkCosts     numLinks      x double
+* nameOffsets   numPositions  x int
+* linkStarts    numLinks      x int
+* linkEnds      numLinks      x int
+* edgeOffsets   numPositions+1 x int
+* edgeTargets   2*numLinks    x int
+* edgeLinks     2*numLinks    x int
+* nameChars     numNameChars  x char
+* imageName     imageNameLength x char
+* Every section starts on a multiple of 8 bytes. Numbers are stored in
+* the byte order of the machine that wrote the file, a file written by
+* a machine with another byte order is treated as stale.
+*/
+
+#ifndef CHART_BINARY_H
+#define CHART_BINARY_H
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include "genlib.h"
+#include "chartparser.h"
+#include "csrgraph.h"
+#include "mappedfile.h"
+
+const char COMPILED_CHART_MAGIC[8] = {'S', 'P', 'F', 'C', 'H', 'A', 'R', 'T'};
+const unsigned int COMPILED_CHART_VERSION = 1;
+const unsigned int BYTE_ORDER_MARK = 0x01020304;
+
+struct compiledChartHeaderT{
+	char magic[8];
+	unsigned int version;
+	unsigned int byteOrderMark;
+	long long sourceSize;
+	long long sourceModified;
+	int numPositions;
+	int numLinks;
+	int numNameChars;
+	int imageNameLength;
+};
+
+/*
+* Function : compiledChartName
+* Usage    : string binaryFileName = compiledChartName("USA.txt");
+* ---------------------------------------------------------------
+* Name of the compiled file that goes with a text data file.
+*/
+string compiledChartName(string dataFileName){
+	return dataFileName + ".bin";
+}
+
+/*
+* Function : getSourceStamp
+* Usage    : if(getSourceStamp("USA.txt", size, modified)) ...
+* ------------------------------------------------------------
+* Looks up the size and modification time of a file, returns false
+* if the file doesn't exist.
+*/
+bool getSourceStamp(string fileName, long long &size, long long &modified){
+	struct stat info;
+	if(stat(fileName.c_str(), &info) != 0) return false;
+	size = info.st_size;
+	modified = info.st_mtime;
+	return true;
+}
+
+// Rounds a byte count up to the next multiple of 8
+long alignSection(long numBytes){
+	return (numBytes + 7) & ~7L;
+}
+
+// Writes an array followed by the zero bytes that pad it to a multiple of 8
+template <typename ElemType>
+void writeSection(FILE * file, const ElemType * elems, long count){
+	long numBytes = count * sizeof(ElemType);
+	if(numBytes > 0) fwrite(elems, 1, numBytes, file);
+	static const char padding[8] = {0};
+	fwrite(padding, 1, alignSection(numBytes) - numBytes, file);
+}
+
+// Copies the next array out of the mapped bytes, returns false if the file is too short
+template <typename ElemType>
+bool readSection(const char * &cursor, const char * end, std::vector<ElemType> &elems, long count){
+	long numBytes = count * sizeof(ElemType);
+	if(count < 0 || end - cursor < alignSection(numBytes)) return false;
+	elems.resize(count);
+	if(numBytes > 0) memcpy(&elems[0], cursor, numBytes);
+	cursor += alignSection(numBytes);
+	return true;
+}
+
+// True if every value lies in the range 0 to limit-1
+bool allInRange(const std::vector<int> &values, int limit){
+	for(int i = 0; i < (int)values.size(); i++)
+		if(values[i] < 0 || values[i] >= limit) return false;
+	return true;
+}
+
+/*
+* Function : writeCompiledChart
+* Usage    : writeCompiledChart("USA.txt.bin", data, "USA.txt");
+* -------------------------------------------------------------
+* Writes data in compiled form, stamped with the size and modification
+* time of the text file it came from. Returns false if the file can't
+* be written.
+*/
+bool writeCompiledChart(string binaryFileName, const ChartData &data, string sourceFileName){
+	compiledChartHeaderT header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, COMPILED_CHART_MAGIC, sizeof(header.magic));
+	header.version = COMPILED_CHART_VERSION;
+	header.byteOrderMark = BYTE_ORDER_MARK;
+	if(!getSourceStamp(sourceFileName, header.sourceSize, header.sourceModified)) return false;
+	header.numPositions = data.numPositions();
+	header.numLinks = data.numLinks();
+	const std::vector<char> &nameChars = data.names.getChars();
+	const std::vector<int> &nameOffsets = data.names.getOffsets();
+	header.numNameChars = nameChars.size();
+	header.imageNameLength = data.imageFileName.size();
+
+	// The adjacency is laid out exactly as CSRGraph would lay it out
+	CSRGraph graph;
+	graph.build(data.numPositions(), data.linkStarts, data.linkEnds, data.linkCosts);
+	std::vector<int> edgeOffsets(data.numPositions() + 1);
+	std::vector<int> edgeTargets(2 * data.numLinks()), edgeLinks(2 * data.numLinks());
+	for(int node = 0; node < data.numPositions(); node++)
+		edgeOffsets[node] = graph.firstEdge(node);
+	edgeOffsets[data.numPositions()] = edgeTargets.size();
+	for(int edge = 0; edge < (int)edgeTargets.size(); edge++){
+		edgeTargets[edge] = graph.getTarget(edge);
+		edgeLinks[edge] = graph.getLinkId(edge);
+	}
+
+	// Written under a temporary name first so a reader never sees half a file
+	string tempFileName = binaryFileName + ".tmp";
+	FILE * file = fopen(tempFileName.c_str(), "wb");
+	if(file == NULL) return false;
+	writeSection(file, &header, 1);
+	writeSection(file, data.coords.empty() ? NULL : &data.coords[0], data.coords.size());
+	writeSection(file, data.linkCosts.empty() ? NULL : &data.linkCosts[0], data.linkCosts.size());
+	writeSection(file, nameOffsets.empty() ? NULL : &nameOffsets[0], nameOffsets.size());
+	writeSection(file, data.linkStarts.empty() ? NULL : &data.linkStarts[0], data.linkStarts.size());
+	writeSection(file, data.linkEnds.empty() ? NULL : &data.linkEnds[0], data.linkEnds.size());
+	writeSection(file, &edgeOffsets[0], edgeOffsets.size());
+	writeSection(file, edgeTargets.empty() ? NULL : &edgeTargets[0], edgeTargets.size());
+	writeSection(file, edgeLinks.empty() ? NULL : &edgeLinks[0], edgeLinks.size());
+	writeSection(file, nameChars.empty() ? NULL : &nameChars[0], nameChars.size());
+	writeSection(file, data.imageFileName.data(), data.imageFileName.size());
+	bool written = (ferror(file) == 0);
+	written = (fclose(file) == 0) && written;
+	remove(binaryFileName.c_str());
+	if(!written || rename(tempFileName.c_str(), binaryFileName.c_str()) != 0){
+		remove(tempFileName.c_str());
+		return false;
+	}
+	return true;
+}
+
+/*
+* Function : readCompiledChart
+* Usage    : if(readCompiledChart("USA.txt.bin", "USA.txt", data)) ...
+* -------------------------------------------------------------------
+* Fills data from a compiled chart. Returns false if the compiled file
+* is missing, damaged (cut short, or holding an index out of range, edge
+* offsets out of order or a negative cost), of another version or byte
+* order, or stale with respect to the text file. If the text file itself
+* can't be found the compiled file is used as it is.
+*/
+bool readCompiledChart(string binaryFileName, string sourceFileName, ChartData &data){
+	MappedFile file;
+	if(!file.open(binaryFileName)) return false;
+	const char * cursor = file.getData();
+	const char * end = cursor + file.getSize();
+	if(file.getSize() < (long)sizeof(compiledChartHeaderT)) return false;
+	compiledChartHeaderT header;
+	memcpy(&header, cursor, sizeof(header));
+	cursor += alignSection(sizeof(header));
+	if(memcmp(header.magic, COMPILED_CHART_MAGIC, sizeof(header.magic)) != 0) return false;
+	if(header.version != COMPILED_CHART_VERSION || header.byteOrderMark != BYTE_ORDER_MARK) return false;
+
+	long long sourceSize, sourceModified;
+	if(getSourceStamp(sourceFileName, sourceSize, sourceModified)){
+		if(sourceSize != header.sourceSize || sourceModified != header.sourceModified) return false;
+	}
+
+	std::vector<char> imageName, nameChars;
+	std::vector<int> nameOffsets;
+	bool complete = readSection(cursor, end, data.coords, header.numPositions)
+		&& readSection(cursor, end, data.linkCosts, header.numLinks)
+		&& readSection(cursor, end, nameOffsets, header.numPositions)
+		&& readSection(cursor, end, data.linkStarts, header.numLinks)
+		&& readSection(cursor, end, data.linkEnds, header.numLinks)
+		&& readSection(cursor, end, data.edgeOffsets, header.numPositions + 1)
+		&& readSection(cursor, end, data.edgeTargets, 2 * (long)header.numLinks)
+		&& readSection(cursor, end, data.edgeLinks, 2 * (long)header.numLinks)
+		&& readSection(cursor, end, nameChars, header.numNameChars)
+		&& readSection(cursor, end, imageName, header.imageNameLength);
+	// A quick look at the array ends catches files cut short or mangled
+	if(complete){
+		complete = data.edgeOffsets[header.numPositions] == 2 * header.numLinks
+			&& (header.numPositions == 0 || (header.numNameChars > 0 && nameChars[header.numNameChars - 1] == '\0'));
+	}
+	// Every name is hashed on the way in, so every offset must point into the block
+	complete = complete && allInRange(nameOffsets, header.numNameChars);
+	// The index arrays are used as they are, so a damaged one must not get past here
+	complete = complete && allInRange(data.linkStarts, header.numPositions)
+		&& allInRange(data.linkEnds, header.numPositions)
+		&& allInRange(data.edgeTargets, header.numPositions)
+		&& allInRange(data.edgeLinks, header.numLinks)
+		&& data.edgeOffsets[0] == 0;
+	for(int posId = 0; complete && posId < header.numPositions; posId++)
+		complete = data.edgeOffsets[posId] <= data.edgeOffsets[posId + 1];
+	for(int linkId = 0; complete && linkId < header.numLinks; linkId++)
+		complete = data.linkCosts[linkId] >= 0;
+	if(!complete){
+		data = ChartData();
+		return false;
+	}
+	data.names.assign(nameChars, nameOffsets);
+	data.imageFileName = imageName.empty() ? "" : string(&imageName[0], imageName.size());
+	return true;
+}
+
+/*
+* Function : loadChartData
+* Usage    : loadChartData("USA.txt", data);
+* -------------------------------------------
+* Fills data from the compiled form of the text data file if that is
+* up to date, otherwise parses the text file and (re)writes the compiled
+* form for next time. Failing to write it is not an error.
+*/
+void loadChartData(string dataFileName, ChartData &data){
+	string binaryFileName = compiledChartName(dataFileName);
+	if(readCompiledChart(binaryFileName, dataFileName, data)) return;
+	ChartParser parser;
+	parser.parseFile(dataFileName, data);
+	writeCompiledChart(binaryFileName, data, dataFileName);
+}
+
+#endif
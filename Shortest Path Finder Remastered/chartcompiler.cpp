@@ -0,0 +1,56 @@
+/*
+* File : chartcompiler.cpp
+* -------------------------
+* A small command line tool that compiles chart data files ahead of time,
+* e.g. as a build step, so that even the first run of the path finder
+* starts from the compiled form.
+*
+* Usage : chartcompiler USA.txt Stanford.txt ...
+*
+* Every text data file named on the command line is parsed and written
+* out next to itself as a compiled chart (USA.txt -> USA.txt.bin), see
+* chartbinary.h, along with its contraction hierarchy (USA.txt.ch), see
+* contractionhierarchy.h. This file has its own main and is built as a
+* separate console program from the path finder itself:
+* chartcompiler.vcproj in the solution, or elsewhere
+*
+*     g++ -O2 -I<CS106 include dir> -o chartcompiler chartcompiler.cpp
+*/
+
+#include <iostream>
+#include "chartbinary.h"
+#include "contractionhierarchy.h"
+
+int main(int argc, char * argv[]){
+	if(argc < 2){
+		cout<<"Usage : chartcompiler dataFile.txt ..."<<endl;
+		return 1;
+	}
+	int numFailed = 0;
+	for(int i = 1; i < argc; i++){
+		string dataFileName = argv[i];
+		ChartData data;
+		ChartParser parser;
+		parser.parseFile(dataFileName, data);
+		string binaryFileName = compiledChartName(dataFileName);
+		if(writeCompiledChart(binaryFileName, data, dataFileName)){
+			cout<<dataFileName<<" -> "<<binaryFileName<<" ("<<data.numPositions()<<" positions, "
+				<<data.numLinks()<<" links)"<<endl;
+		}else{
+			cout<<"Can't write "<<binaryFileName<<endl;
+			numFailed++;
+		}
+		CSRGraph graph;
+		graph.build(data.numPositions(), data.linkStarts, data.linkEnds, data.linkCosts);
+		ContractionHierarchy hierarchy;
+		hierarchy.build(graph);
+		string hierarchyName = hierarchyFileName(dataFileName);
+		if(hierarchy.save(hierarchyName, dataFileName)){
+			cout<<dataFileName<<" -> "<<hierarchyName<<" ("<<hierarchy.numShortcuts()<<" shortcuts)"<<endl;
+		}else{
+			cout<<"Can't write "<<hierarchyName<<endl;
+			numFailed++;
+		}
+	}
+	return (numFailed == 0) ? 0 : 1;
+}
@@ -0,0 +1,202 @@
+/*
+* File : chartgenerator.h
+* ------------------------
+* Makes up charts of any size for testing and benchmarking, in three
+* kinds:
+*
+* GRID_GRAPH      : positions on a square grid, every one linked to the
+*                   ones right of and above it
+* GEOMETRIC_GRAPH : positions scattered at random over a square, every
+*                   pair closer than a fixed radius linked, about six
+*                   links per position
+* ROAD_GRAPH      : a jittered grid of slow local streets with some
+*                   missing, faster arterial roads along every 8th row
+*                   and column and highways along every 32nd that skip
+*                   ahead several positions at a time
+*
+* Positions are about one unit apart and named p0, p1, p2 ... The cost
+* of a link is its length times a random factor, so coordinates say
+* something about costs as they do on a real map. The same kind, size
+* and seed always give the same chart.
+*/
+
+#ifndef CHART_GENERATOR_H
+#define CHART_GENERATOR_H
+
+#include <cstdio>
+#include <cmath>
+#include <vector>
+#include "genlib.h"
+#include "chartparser.h"
+#include "spatialindex.h"
+
+enum graphKindT {GRID_GRAPH, GEOMETRIC_GRAPH, ROAD_GRAPH};
+
+/*
+* Function : graphKindName, graphKindFromName
+* Usage    : string name = graphKindName(GRID_GRAPH);
+* ---------------------------------------------------
+* Convert between a kind of chart and its name (grid, geometric or
+* road). graphKindFromName returns false for an unknown name.
+*/
+string graphKindName(graphKindT kind){
+	switch(kind){
+	case GRID_GRAPH: return "grid";
+	case GEOMETRIC_GRAPH: return "geometric";
+	default: return "road";
+	}
+}
+
+bool graphKindFromName(string name, graphKindT &kind){
+	if(name == "grid") kind = GRID_GRAPH;
+	else if(name == "geometric") kind = GEOMETRIC_GRAPH;
+	else if(name == "road") kind = ROAD_GRAPH;
+	else return false;
+	return true;
+}
+
+/*
+* A small linear congruential generator, so generated charts are the
+* same on every platform (rand() isn't, and gives only 15 bits on some).
+*/
+class RandomStream{
+public:
+	RandomStream(unsigned int seed){
+		state = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+	}
+
+	// Uniform in [0, 1)
+	double nextDouble(){
+		state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+		return (state >> 11) * (1.0 / 9007199254740992.0);
+	}
+
+	// Uniform in [low, high)
+	double nextDouble(double low, double high){
+		return low + (high - low) * nextDouble();
+	}
+
+private:
+	unsigned long long state;
+};
+
+// Adds a position named p<id> to the data
+void addGeneratedPosition(ChartData &data, double x, double y){
+	char name[16];
+	sprintf(name, "p%d", data.numPositions());
+	data.names.add(name, strlen(name));
+	coordT coords = {x, y};
+	data.coords.push_back(coords);
+}
+
+// Links two positions at their distance times costFactor
+void addGeneratedLink(ChartData &data, int start, int end, double costFactor){
+	double dx = data.coords[end].x - data.coords[start].x;
+	double dy = data.coords[end].y - data.coords[start].y;
+	data.linkStarts.push_back(start);
+	data.linkEnds.push_back(end);
+	data.linkCosts.push_back(std::sqrt(dx*dx + dy*dy) * costFactor);
+}
+
+void generateGridChart(int numPositions, RandomStream &random, ChartData &data){
+	int side = (int)std::ceil(std::sqrt((double)numPositions));
+	for(int i = 0; i < numPositions; i++)
+		addGeneratedPosition(data, i % side, i / side);
+	for(int i = 0; i < numPositions; i++){
+		if(i % side + 1 < side && i + 1 < numPositions) addGeneratedLink(data, i, i + 1, random.nextDouble(1, 2));
+		if(i + side < numPositions) addGeneratedLink(data, i, i + side, random.nextDouble(1, 2));
+	}
+}
+
+void generateGeometricChart(int numPositions, RandomStream &random, ChartData &data){
+	double side = std::sqrt((double)numPositions);
+	for(int i = 0; i < numPositions; i++)
+		addGeneratedPosition(data, random.nextDouble(0, side), random.nextDouble(0, side));
+
+	// At one position per unit of area this radius gives six neighbors on average
+	const double radius = std::sqrt(6 / 3.14159265358979);
+	SpatialIndex index;
+	index.build(data.coords);
+	std::vector<int> near;
+	for(int i = 0; i < numPositions; i++){
+		index.findWithin(data.coords[i], radius, near);
+		for(int j = 0; j < (int)near.size(); j++)
+			if(near[j] > i) addGeneratedLink(data, i, near[j], random.nextDouble(1, 1.2));
+	}
+}
+
+void generateRoadChart(int numPositions, RandomStream &random, ChartData &data){
+	const int ARTERIAL_SPACING = 8;
+	const int HIGHWAY_SPACING = 32;
+	const int HIGHWAY_STRIDE = 4;
+	int side = (int)std::ceil(std::sqrt((double)numPositions));
+	for(int i = 0; i < numPositions; i++)
+		addGeneratedPosition(data, i % side + random.nextDouble(-0.3, 0.3), i / side + random.nextDouble(-0.3, 0.3));
+
+	for(int i = 0; i < numPositions; i++){
+		int column = i % side, row = i / side;
+		// Along the row
+		if(column + 1 < side && i + 1 < numPositions){
+			if(row % ARTERIAL_SPACING == 0) addGeneratedLink(data, i, i + 1, random.nextDouble(1, 1.2));
+			else if(random.nextDouble() < 0.85) addGeneratedLink(data, i, i + 1, random.nextDouble(1.5, 2.5));
+		}
+		if(row % HIGHWAY_SPACING == 0 && column % HIGHWAY_STRIDE == 0
+			&& column + HIGHWAY_STRIDE < side && i + HIGHWAY_STRIDE < numPositions){
+			addGeneratedLink(data, i, i + HIGHWAY_STRIDE, random.nextDouble(0.5, 0.6));
+		}
+		// Along the column
+		if(i + side < numPositions){
+			if(column % ARTERIAL_SPACING == 0) addGeneratedLink(data, i, i + side, random.nextDouble(1, 1.2));
+			else if(random.nextDouble() < 0.85) addGeneratedLink(data, i, i + side, random.nextDouble(1.5, 2.5));
+		}
+		if(column % HIGHWAY_SPACING == 0 && row % HIGHWAY_STRIDE == 0 && i + HIGHWAY_STRIDE * side < numPositions){
+			addGeneratedLink(data, i, i + HIGHWAY_STRIDE * side, random.nextDouble(0.5, 0.6));
+		}
+	}
+}
+
+/*
+* Function : generateChart
+* Usage    : generateChart(ROAD_GRAPH, 100000, seed, data);
+* ---------------------------------------------------------
+* Fills data with a made up chart of the given kind and number of
+* positions.
+*/
+void generateChart(graphKindT kind, int numPositions, unsigned int seed, ChartData &data){
+	data = ChartData();
+	data.imageFileName = "blank.bmp";
+	RandomStream random(seed);
+	switch(kind){
+	case GRID_GRAPH:
+		generateGridChart(numPositions, random, data);
+		break;
+	case GEOMETRIC_GRAPH:
+		generateGeometricChart(numPositions, random, data);
+		break;
+	default:
+		generateRoadChart(numPositions, random, data);
+		break;
+	}
+}
+
+/*
+* Function : writeChartText
+* Usage    : writeChartText("grid1000.txt", data);
+* -------------------------------------------------
+* Writes data as a text data file in the format described in chart.h.
+* Returns false if the file can't be written.
+*/
+bool writeChartText(string fileName, const ChartData &data){
+	FILE * file = fopen(fileName.c_str(), "w");
+	if(file == NULL) return false;
+	fprintf(file, "%s\nNODES\n", data.imageFileName.c_str());
+	for(int i = 0; i < data.numPositions(); i++)
+		fprintf(file, "%s %.4f %.4f\n", data.getName(i), data.coords[i].x, data.coords[i].y);
+	fprintf(file, "ARCS\n");
+	for(int i = 0; i < data.numLinks(); i++)
+		fprintf(file, "%s %s %.4f\n", data.getName(data.linkStarts[i]), data.getName(data.linkEnds[i]), data.linkCosts[i]);
+	bool written = (ferror(file) == 0);
+	return (fclose(file) == 0) && written;
+}
+
+#endif
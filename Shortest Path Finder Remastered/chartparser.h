@@ -0,0 +1,266 @@
+/*
+* File : chartparser.h
+* ---------------------
+* Defines the ChartData structure which holds everything a chart data
+* file describes, and the ChartParser class which fills one in from a
+* data file in the text format documented in chart.h.
+*
+* Implementation notes
+* ---------------------
+* The whole file is read into memory with a single read and scanned once,
+* line by line, with a pointer. Names are copied straight out of the
+* buffer into the NameTable of the data, numbers are converted by a hand
+* written scanner and the ends of every arc are resolved to node ids
+* through that table, so no string object is created per line. Anything
+* that doesn't fit the format is reported through Error together with
+* the line it was found on.
+*/
+
+#ifndef CHART_PARSER_H
+#define CHART_PARSER_H
+
+#include <cstdio>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "genlib.h"
+#include "position.h"
+#include "nametable.h"
+
+/*
+* ChartData
+* ----------
+* Positions are numbered 0, 1, 2 ... in the order they appear in the file,
+* which is also the id of their name in names. Link i joins positions
+* linkStarts[i] and linkEnds[i].
+* A chart read back from its compiled form also carries the adjacency in
+* the layout CSRGraph uses (edgeOffsets, edgeTargets, edgeLinks), for
+* one parsed from text these are left empty.
+*/
+struct ChartData{
+	string imageFileName;
+	NameTable names;
+	std::vector<coordT> coords;
+	std::vector<int> linkStarts;
+	std::vector<int> linkEnds;
+	std::vector<double> linkCosts;
+	std::vector<int> edgeOffsets;
+	std::vector<int> edgeTargets;
+	std::vector<int> edgeLinks;
+
+	int numPositions() const { return names.size(); }
+	int numLinks() const { return linkStarts.size(); }
+	const char * getName(int posId) const { return names.getName(posId); }
+};
+
+class ChartParser{
+public:
+	/*
+	* Function : parseFile
+	* Usage    : parser.parseFile("USA.txt", data);
+	* ----------------------------------------------
+	* Reads the named data file into data. Calls Error with the file name
+	* and line number if the file can't be read or is malformed. Files
+	* larger than INT_MAX bytes (2 GB) can't be read.
+	*/
+	void parseFile(string fileName, ChartData &data);
+
+	/*
+	* Function : parseText
+	* Usage    : parser.parseText(text, length, "USA.txt", data);
+	* -------------------------------------------------------------
+	* Same as parseFile for text that is already in memory, sourceName
+	* is only used in error messages.
+	*/
+	void parseText(const char * text, int length, string sourceName, ChartData &data);
+
+private:
+	const char * cursor;
+	const char * end;
+	int lineNumber;
+	string source;
+	ChartData * result;
+
+	bool nextLine(const char * &lineStart, const char * &lineEnd);
+	bool nextToken(const char * &pos, const char * lineEnd, const char * &tokenStart, int &tokenLength);
+	double scanNumber(const char * token, int length);
+	bool tokenIs(const char * token, int length, const char * word);
+
+	void parseError(string message);
+};
+
+void ChartParser::parseFile(string fileName, ChartData &data){
+	FILE * file = fopen(fileName.c_str(), "rb");
+	if(file == NULL) Error("Can't open data file " + fileName);
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	// ftell fails on files past the range of a long, which is 32 bits on Windows
+	if(size < 0 || size > INT_MAX){
+		fclose(file);
+		Error("Data file " + fileName + " is too large, the limit is 2 GB");
+	}
+	fseek(file, 0, SEEK_SET);
+	std::vector<char> text(size + 1);
+	long numRead = (size > 0) ? fread(&text[0], 1, size, file) : 0;
+	fclose(file);
+	if(numRead != size) Error("Can't read data file " + fileName);
+	parseText(&text[0], (int)size, fileName, data);
+}
+
+void ChartParser::parseText(const char * text, int length, string sourceName, ChartData &data){
+	cursor = text;
+	end = text + length;
+	lineNumber = 0;
+	source = sourceName;
+	result = &data;
+	data = ChartData();
+
+	enum { IMAGE, NODES_MARKER, NODES, ARCS } section = IMAGE;
+	const char * lineStart, * lineEnd;
+	while(nextLine(lineStart, lineEnd)){
+		const char * pos = lineStart;
+		const char * tokens[3];
+		int lengths[3];
+		int numTokens = 0;
+		const char * token;
+		int tokenLength;
+		while(nextToken(pos, lineEnd, token, tokenLength)){
+			if(numTokens == 3) parseError("too many fields");
+			tokens[numTokens] = token;
+			lengths[numTokens] = tokenLength;
+			numTokens++;
+		}
+		if(numTokens == 0) continue;
+
+		switch(section){
+		case IMAGE:
+			if(numTokens != 1) parseError("expected the name of the image file");
+			data.imageFileName = string(tokens[0], lengths[0]);
+			section = NODES_MARKER;
+			break;
+		case NODES_MARKER:
+			if(numTokens != 1 || !tokenIs(tokens[0], lengths[0], "NODES")) parseError("expected NODES");
+			section = NODES;
+			break;
+		case NODES:
+			if(numTokens == 1 && tokenIs(tokens[0], lengths[0], "ARCS")){
+				section = ARCS;
+				break;
+			}
+			if(numTokens != 3) parseError("expected a position as: name x y");
+			if(data.names.find(tokens[0], lengths[0]) != -1)
+				parseError("position " + string(tokens[0], lengths[0]) + " is defined twice");
+			{
+				coordT posCoords = {scanNumber(tokens[1], lengths[1]), scanNumber(tokens[2], lengths[2])};
+				data.names.add(tokens[0], lengths[0]);
+				data.coords.push_back(posCoords);
+			}
+			break;
+		case ARCS:
+			if(numTokens != 3) parseError("expected a link as: startName endName cost");
+			{
+				int startId = data.names.find(tokens[0], lengths[0]);
+				int endId = data.names.find(tokens[1], lengths[1]);
+				if(startId == -1) parseError("no position named " + string(tokens[0], lengths[0]));
+				if(endId == -1) parseError("no position named " + string(tokens[1], lengths[1]));
+				data.linkStarts.push_back(startId);
+				data.linkEnds.push_back(endId);
+				double cost = scanNumber(tokens[2], lengths[2]);
+				// Every search assumes that no link costs less than nothing
+				if(!(cost >= 0)) parseError("link cost can't be negative: " + string(tokens[2], lengths[2]));
+				data.linkCosts.push_back(cost);
+			}
+			break;
+		}
+	}
+	if(section == IMAGE) parseError("the file is empty");
+	if(section == NODES_MARKER) parseError("reached the end of the file looking for NODES");
+	if(section == NODES) parseError("reached the end of the file looking for ARCS");
+}
+
+// Moves the cursor past the next line, the line ending (\n or \r\n) is left out
+bool ChartParser::nextLine(const char * &lineStart, const char * &lineEnd){
+	if(cursor >= end) return false;
+	lineNumber++;
+	lineStart = cursor;
+	const char * newline = (const char *)memchr(cursor, '\n', end - cursor);
+	lineEnd = (newline == NULL) ? end : newline;
+	cursor = (newline == NULL) ? end : newline + 1;
+	if(lineEnd > lineStart && lineEnd[-1] == '\r') lineEnd--;
+	return true;
+}
+
+bool ChartParser::nextToken(const char * &pos, const char * lineEnd, const char * &tokenStart, int &tokenLength){
+	while(pos < lineEnd && (*pos == ' ' || *pos == '\t')) pos++;
+	if(pos == lineEnd) return false;
+	tokenStart = pos;
+	while(pos < lineEnd && *pos != ' ' && *pos != '\t') pos++;
+	tokenLength = pos - tokenStart;
+	return true;
+}
+
+bool ChartParser::tokenIs(const char * token, int length, const char * word){
+	return (int)strlen(word) == length && memcmp(token, word, length) == 0;
+}
+
+/*
+* Implementation notes : scanNumber
+* ----------------------------------
+* Collects the digits into an integer mantissa and a power of ten. As long
+* as the mantissa fits in 2^53 and the power is at most 22 both are exact
+* doubles and a single multiplication or division gives the correctly
+* rounded result. Anything longer is handed to strtod.
+*/
+double ChartParser::scanNumber(const char * token, int length){
+	static const double powersOfTen[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+		1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+	const char * pos = token;
+	const char * tokenEnd = token + length;
+	bool negative = false;
+	if(pos < tokenEnd && (*pos == '-' || *pos == '+')){
+		negative = (*pos == '-');
+		pos++;
+	}
+	double mantissa = 0;
+	int numDigits = 0, exponent = 0;
+	while(pos < tokenEnd && *pos >= '0' && *pos <= '9'){
+		mantissa = mantissa * 10 + (*pos - '0');
+		numDigits++;
+		pos++;
+	}
+	if(pos < tokenEnd && *pos == '.'){
+		pos++;
+		while(pos < tokenEnd && *pos >= '0' && *pos <= '9'){
+			mantissa = mantissa * 10 + (*pos - '0');
+			numDigits++;
+			exponent--;
+			pos++;
+		}
+	}
+	if(numDigits == 0) parseError("expected a number but found " + string(token, length));
+	bool simple = true;
+	if(pos < tokenEnd && (*pos == 'e' || *pos == 'E')) simple = false;
+	else if(pos != tokenEnd) parseError("expected a number but found " + string(token, length));
+
+	if(simple && numDigits <= 15 && exponent >= -22){
+		double value = (exponent < 0) ? mantissa / powersOfTen[-exponent] : mantissa;
+		return negative ? -value : value;
+	}
+	char buffer[64];
+	if(length >= (int)sizeof(buffer)) parseError("number too long: " + string(token, length));
+	memcpy(buffer, token, length);
+	buffer[length] = '\0';
+	char * numberEnd;
+	double value = strtod(buffer, &numberEnd);
+	if(numberEnd != buffer + length) parseError("expected a number but found " + string(token, length));
+	return value;
+}
+
+void ChartParser::parseError(string message){
+	char lineText[16];
+	sprintf(lineText, "%d", lineNumber);
+	Error(source + ", line " + lineText + ": " + message);
+}
+
+#endif
@@ -0,0 +1,74 @@
+/*
+* File : chartrenderer.h
+* -----------------------
+* Defines the ChartRenderer interface. A Chart does no drawing of its
+* own, instead it tells the renderer it was given (if any) what happened:
+* a picture was named, a position or a link was added, a path, a
+* spanning tree link or a link within reach was found. A Chart made
+* without a renderer never makes a graphics call and never pauses,
+* which is what batch and server use want.
+*
+* Every notification does nothing by default, so a renderer only needs
+* to override those it cares about.
+*/
+
+#ifndef CHART_RENDERER_H
+#define CHART_RENDERER_H
+
+#include "path.h"
+#include "position.h"
+
+/*
+* Constants
+* ----------
+* The radius of a position as drawn on screen, a click within
+* a diameter of a position is taken to be on that position.
+*/
+const double CircleRadius =.05;
+
+class ChartRenderer{
+public:
+	virtual ~ChartRenderer(){}
+
+	/*
+	* Function : chartOpened
+	* -----------------------
+	* Called first thing while loading with the name of the
+	* background picture named in the data file.
+	*/
+	virtual void chartOpened(string /* imageFileName */){}
+
+	/*
+	* Function : positionAdded, linkAdded
+	* ------------------------------------
+	* Called for every position and link as the data file is loaded,
+	* and for every link added to the chart later on.
+	*/
+	virtual void positionAdded(Position * /* pos */){}
+	virtual void linkAdded(Link * /* link */){}
+
+	/*
+	* Function : pathFound
+	* ---------------------
+	* Called by Chart::findShortestPathBetween with the path found.
+	*/
+	virtual void pathFound(Path & /* path */){}
+
+	/*
+	* Function : spanningTreeLinkFound
+	* ---------------------------------
+	* Called by Chart::findMinimalSpanningTree for every link of
+	* the tree in the order the links are accepted.
+	*/
+	virtual void spanningTreeLinkFound(Link * /* link */){}
+
+	/*
+	* Function : reachableLinkFound
+	* ------------------------------
+	* Called by Chart::findReachableWithin for every link that can be
+	* crossed within the budget, nearest first.
+	*/
+	virtual void reachableLinkFound(Link * /* link */){}
+};
+
+#endif
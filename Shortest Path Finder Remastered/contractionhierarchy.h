@@ -0,0 +1,704 @@
+/*
+* File : contractionhierarchy.h
+* ------------------------------
+* Defines the ContractionHierarchy class which answers shortest path
+* queries on a chart that doesn't change far faster than a plain search
+* does, in return for a preprocessing step that is paid once per chart.
+*
+* Preprocessing takes the nodes away (contracts them) one at a time,
+* least important first. Whenever the only cheapest way between two
+* neighbors of the node being taken away runs through it, a shortcut
+* link is added between the two neighbors with the cost of that way.
+* A shortcut remembers the two links (original links or shortcuts
+* themselves) it stands for. The order the nodes were taken away in is
+* their rank.
+*
+* A query then searches upwards from the start and upwards from the end
+* at the same time, only ever following links to nodes of a higher rank,
+* and the cheapest node where the two searches meet lies on a shortest
+* path. Such searches look at a tiny part of the graph. The shortcuts on
+* the path found are finally unpacked into the original links.
+*
+* The hierarchy can be saved next to the data file it belongs to and
+* loaded back, see save and load.
+*/
+
+#ifndef CONTRACTION_HIERARCHY_H
+#define CONTRACTION_HIERARCHY_H
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include "genlib.h"
+#include "csrgraph.h"
+#include "indexedheap.h"
+#include "chartbinary.h"
+#include "searchstats.h"
+
+const char HIERARCHY_MAGIC[8] = {'S', 'P', 'F', 'H', 'I', 'E', 'R', 'A'};
+const unsigned int HIERARCHY_VERSION = 2;
+
+// Nodes looked at by one witness search before it gives up
+const int WITNESS_SETTLE_LIMIT = 500;
+
+/*
+* Function : hierarchyFileName
+* Usage    : string fileName = hierarchyFileName("USA.txt");
+* ---------------------------------------------------------
+* Name of the file the hierarchy of a text data file is saved to.
+*/
+string hierarchyFileName(string dataFileName){
+	return dataFileName + ".ch";
+}
+
+class ContractionHierarchy{
+public:
+	ContractionHierarchy();
+
+	/*
+	* Function : build
+	* Usage    : hierarchy.build(graph);
+	* -----------------------------------
+	* Contracts every node of the graph and adds the shortcuts. Link ids
+	* handed out by queries are the link ids of this graph.
+	*/
+	void build(const CSRGraph &graph);
+
+	/*
+	* Function : isBuilt
+	* Usage    : if(!hierarchy.isBuilt()) ...
+	* -----------------------------------------
+	* True once build or load succeeded.
+	*/
+	bool isBuilt();
+
+	/*
+	* Function : save
+	* Usage    : hierarchy.save("USA.txt.ch", "USA.txt");
+	* ---------------------------------------------------
+	* Writes the hierarchy to a file stamped with the size and time of
+	* the data file it was built from. Returns false if it can't.
+	*/
+	bool save(string fileName, string sourceFileName);
+
+	/*
+	* Function : load
+	* Usage    : if(!hierarchy.load("USA.txt.ch", "USA.txt", graph)) ...
+	* ------------------------------------------------------------------
+	* Reads back a saved hierarchy. Returns false, leaving the hierarchy
+	* unbuilt, if the file is missing or damaged (see isWellFormed), was
+	* saved for another version of the data file or doesn't fit the graph.
+	*/
+	bool load(string fileName, string sourceFileName, const CSRGraph &graph);
+
+	/*
+	* Function : findShortestPath
+	* Usage    : if(hierarchy.findShortestPath(startId, endId)) ...
+	* -------------------------------------------------------------
+	* Returns false if end can't be reached from start. Afterwards
+	* getPathCost and getPathLinks describe the path found.
+	*/
+	bool findShortestPath(int start, int end);
+
+	double getPathCost();
+
+	/*
+	* Function : getPathLinks
+	* Usage    : hierarchy.getPathLinks(linkIds);
+	* --------------------------------------------
+	* Fills linkIds with the ids of the original links of the last path
+	* found, shortcuts unpacked, in order from the start.
+	*/
+	void getPathLinks(std::vector<int> &linkIds);
+
+	int numShortcuts();
+
+	/*
+	* Function : getStats
+	* Usage    : searchStatsT stats = hierarchy.getStats();
+	* ------------------------------------------------------
+	* What the last query did, all zero unless compiled with
+	* COLLECT_SEARCH_STATS (see searchstats.h).
+	*/
+	searchStatsT getStats();
+
+private:
+	/*
+	* An arc joins endA and endB. The first numLinks arcs are the links of
+	* the graph (childA is -1), the rest are shortcuts through middle made
+	* of arc childA (endA to middle) and arc childB (middle to endB).
+	*/
+	struct arcT{
+		int endA, endB;
+		double cost;
+		int middle;
+		int childA, childB;
+	};
+
+	struct hierarchyHeaderT{
+		char magic[8];
+		unsigned int version;
+		unsigned int byteOrderMark;
+		long long sourceSize;
+		long long sourceModified;
+		int numNodes;
+		int numLinks;
+		int numArcs;
+	};
+
+	// The labels of one direction of a query, indexed by node id
+	struct queryLabelsT{
+		std::vector<double> distances;
+		std::vector<int> predecessorArcs;
+		std::vector<int> touched;
+		IndexedHeap<double> frontier;
+	};
+
+	int nodeCount;
+	int linkCount;
+	bool built;
+	std::vector<arcT> arcs;
+	std::vector<int> rank;
+
+	// Arcs leading to a node of higher rank, in compressed sparse row form
+	std::vector<int> upOffsets;
+	std::vector<int> upTargets;
+	std::vector<double> upCosts;
+	std::vector<int> upArcs;
+
+	queryLabelsT forward, backward;
+	int pathStart, meetingNode;
+	double pathCost;
+	searchStatsT stats;
+
+	// Used only while building
+	std::vector<std::vector<int> > nodeArcs;   // arcs to nodes not contracted yet
+	std::vector<int> neighborSlot;
+	std::vector<double> witnessDistances;
+	std::vector<int> witnessTouched;
+	IndexedHeap<double> witnessFrontier;
+
+	int contractNode(int node, bool addShortcuts);
+	double nodePriority(int node, int numDeletedNeighbors);
+	void witnessSearch(int source, int skipNode, double maxCost, int firstTarget, int numTargets);
+	void removeArcsTo(int node, int removedNode);
+	int otherEnd(const arcT &arc, int node);
+
+	void buildUpwardGraph();
+	bool isWellFormed();
+	bool joins(int arcId, int one, int two);
+	void settleUpwards(queryLabelsT &side, queryLabelsT &otherSide);
+	void resetLabels(queryLabelsT &labels);
+	void label(queryLabelsT &labels, int node, double distance, int arcId);
+	void unpackArc(int arcId, int fromNode, std::vector<int> &linkIds);
+};
+
+ContractionHierarchy::ContractionHierarchy(){
+	nodeCount = linkCount = 0;
+	built = false;
+	pathStart = meetingNode = -1;
+	pathCost = std::numeric_limits<double>::infinity();
+	stats = NO_SEARCH_STATS;
+}
+
+/*
+* Implementation notes : build
+* -----------------------------
+* The next node to contract is the one with the lowest priority, twice
+* the number of shortcuts contracting it would add minus the number of
+* arcs it takes away, plus the number of its neighbors already contracted
+* so that contraction spreads evenly over the graph. Priorities go stale as
+* the graph changes, so the node on top of the queue is looked at again
+* before it is contracted and put back if it is no longer the lowest,
+* and the neighbors of every contracted node are brought up to date.
+*/
+void ContractionHierarchy::build(const CSRGraph &graph){
+	nodeCount = graph.numNodes();
+	linkCount = graph.numLinks();
+	arcs.resize(linkCount);
+	nodeArcs.assign(nodeCount, std::vector<int>());
+	for(int i = 0; i < linkCount; i++){
+		// A removed link keeps its arc, at a cost no search will follow
+		double cost = graph.isLinkRemoved(i) ? std::numeric_limits<double>::infinity() : graph.getLinkCost(i);
+		arcT arc = {graph.getLinkStart(i), graph.getLinkEnd(i), cost, -1, -1, -1};
+		arcs[i] = arc;
+		if(arc.endA == arc.endB || graph.isLinkRemoved(i)) continue;
+		nodeArcs[arc.endA].push_back(i);
+		nodeArcs[arc.endB].push_back(i);
+	}
+	neighborSlot.assign(nodeCount, -1);
+	witnessDistances.assign(nodeCount, std::numeric_limits<double>::infinity());
+	witnessTouched.clear();
+	witnessFrontier.reserve(nodeCount);
+
+	std::vector<int> deletedNeighbors(nodeCount, 0);
+	IndexedHeap<double> queue(nodeCount);
+	for(int node = 0; node < nodeCount; node++)
+		queue.enqueue(node, nodePriority(node, 0));
+
+	rank.assign(nodeCount, -1);
+	int nextRank = 0;
+	while(!queue.isEmpty()){
+		int node = queue.dequeueMin();
+		double priority = nodePriority(node, deletedNeighbors[node]);
+		if(!queue.isEmpty() && priority > queue.peekMinKey()){
+			queue.enqueue(node, priority);
+			continue;
+		}
+		contractNode(node, true);
+		rank[node] = nextRank++;
+
+		std::vector<int> neighbors;
+		std::vector<int> &incident = nodeArcs[node];
+		for(int i = 0; i < (int)incident.size(); i++){
+			int neighbor = otherEnd(arcs[incident[i]], node);
+			if(neighborSlot[neighbor] != -1) continue;
+			neighborSlot[neighbor] = neighbors.size();
+			neighbors.push_back(neighbor);
+		}
+		std::vector<int>().swap(incident);
+		for(int i = 0; i < (int)neighbors.size(); i++){
+			neighborSlot[neighbors[i]] = -1;
+			removeArcsTo(neighbors[i], node);
+		}
+		for(int i = 0; i < (int)neighbors.size(); i++){
+			int neighbor = neighbors[i];
+			deletedNeighbors[neighbor]++;
+			queue.changeKey(neighbor, nodePriority(neighbor, deletedNeighbors[neighbor]));
+		}
+	}
+
+	std::vector<std::vector<int> >().swap(nodeArcs);
+	std::vector<int>().swap(neighborSlot);
+	std::vector<double>().swap(witnessDistances);
+	witnessFrontier.reserve(0);
+	buildUpwardGraph();
+}
+
+double ContractionHierarchy::nodePriority(int node, int numDeletedNeighbors){
+	int numShortcuts = contractNode(node, false);
+	return 2 * (numShortcuts - (int)nodeArcs[node].size()) + numDeletedNeighbors;
+}
+
+/*
+* Implementation notes : contractNode
+* ------------------------------------
+* Collects the cheapest arc to every neighbor not contracted yet. For
+* each neighbor a witness search, which may not pass through the node,
+* looks for a way to the other neighbors at most as expensive as the
+* way through the node; only the pairs left without one need a shortcut.
+* Since arcs work both ways each pair is only looked at from the side of
+* its first neighbor, and a witness search ends as soon as it has
+* settled every neighbor it is looking for. Returns the number of
+* shortcuts needed, adding them only if asked to.
+*/
+int ContractionHierarchy::contractNode(int node, bool addShortcuts){
+	std::vector<int> neighbors;
+	std::vector<int> neighborArcs;
+	const std::vector<int> &incident = nodeArcs[node];
+	for(int i = 0; i < (int)incident.size(); i++){
+		const arcT &arc = arcs[incident[i]];
+		int neighbor = otherEnd(arc, node);
+		int slot = neighborSlot[neighbor];
+		if(slot != -1){
+			if(arc.cost < arcs[neighborArcs[slot]].cost) neighborArcs[slot] = incident[i];
+			continue;
+		}
+		neighborSlot[neighbor] = neighbors.size();
+		neighbors.push_back(neighbor);
+		neighborArcs.push_back(incident[i]);
+	}
+
+	// Most expensive arc to any neighbor after the i-th
+	int numNeighbors = neighbors.size();
+	std::vector<double> maxLaterCost(numNeighbors + 1, 0);
+	for(int i = numNeighbors - 1; i >= 0; i--)
+		maxLaterCost[i] = std::max(maxLaterCost[i + 1], arcs[neighborArcs[i]].cost);
+
+	int numShortcuts = 0;
+	for(int i = 0; i + 1 < numNeighbors; i++){
+		double costIn = arcs[neighborArcs[i]].cost;
+		witnessSearch(neighbors[i], node, costIn + maxLaterCost[i + 1], i + 1, numNeighbors - i - 1);
+		for(int j = i + 1; j < (int)neighbors.size(); j++){
+			double throughCost = costIn + arcs[neighborArcs[j]].cost;
+			if(witnessDistances[neighbors[j]] <= throughCost) continue;
+			numShortcuts++;
+			if(!addShortcuts) continue;
+			arcT shortcut = {neighbors[i], neighbors[j], throughCost, node, neighborArcs[i], neighborArcs[j]};
+			arcs.push_back(shortcut);
+			nodeArcs[neighbors[i]].push_back(arcs.size() - 1);
+			nodeArcs[neighbors[j]].push_back(arcs.size() - 1);
+		}
+	}
+	for(int i = 0; i < numNeighbors; i++)
+		neighborSlot[neighbors[i]] = -1;
+	return numShortcuts;
+}
+
+/*
+* Dijkstra over the nodes not contracted yet, leaving out skipNode. The
+* nodes looked for are the neighbors of skipNode in slots firstTarget on.
+*/
+void ContractionHierarchy::witnessSearch(int source, int skipNode, double maxCost, int firstTarget, int numTargets){
+	for(int i = 0; i < (int)witnessTouched.size(); i++)
+		witnessDistances[witnessTouched[i]] = std::numeric_limits<double>::infinity();
+	witnessTouched.clear();
+	witnessFrontier.clear();
+
+	witnessDistances[source] = 0;
+	witnessTouched.push_back(source);
+	witnessFrontier.enqueue(source, 0);
+	int numSettled = 0;
+	while(!witnessFrontier.isEmpty() && numSettled < WITNESS_SETTLE_LIMIT){
+		if(witnessFrontier.peekMinKey() > maxCost) break;
+		int current = witnessFrontier.dequeueMin();
+		numSettled++;
+		if(neighborSlot[current] >= firstTarget && --numTargets == 0) break;
+		const std::vector<int> &incident = nodeArcs[current];
+		for(int i = 0; i < (int)incident.size(); i++){
+			const arcT &arc = arcs[incident[i]];
+			int neighbor = otherEnd(arc, current);
+			if(neighbor == skipNode) continue;
+			double newDistance = witnessDistances[current] + arc.cost;
+			if(newDistance >= witnessDistances[neighbor]) continue;
+			if(witnessDistances[neighbor] == std::numeric_limits<double>::infinity()){
+				witnessTouched.push_back(neighbor);
+				witnessFrontier.enqueue(neighbor, newDistance);
+			}else if(witnessFrontier.contains(neighbor)){
+				witnessFrontier.decreaseKey(neighbor, newDistance);
+			}else{
+				continue;
+			}
+			witnessDistances[neighbor] = newDistance;
+		}
+	}
+}
+
+void ContractionHierarchy::removeArcsTo(int node, int removedNode){
+	std::vector<int> &incident = nodeArcs[node];
+	int numKept = 0;
+	for(int i = 0; i < (int)incident.size(); i++){
+		if(otherEnd(arcs[incident[i]], node) != removedNode) incident[numKept++] = incident[i];
+	}
+	incident.resize(numKept);
+}
+
+int ContractionHierarchy::otherEnd(const arcT &arc, int node){
+	return (arc.endA == node) ? arc.endB : arc.endA;
+}
+
+// Every arc is stored once, at whichever of its ends has the lower rank
+void ContractionHierarchy::buildUpwardGraph(){
+	upOffsets.assign(nodeCount + 1, 0);
+	for(int i = 0; i < (int)arcs.size(); i++){
+		const arcT &arc = arcs[i];
+		if(arc.endA == arc.endB) continue;
+		int lower = (rank[arc.endA] < rank[arc.endB]) ? arc.endA : arc.endB;
+		upOffsets[lower + 1]++;
+	}
+	for(int node = 0; node < nodeCount; node++)
+		upOffsets[node + 1] += upOffsets[node];
+	int numUpArcs = upOffsets[nodeCount];
+	upTargets.resize(numUpArcs);
+	upCosts.resize(numUpArcs);
+	upArcs.resize(numUpArcs);
+	std::vector<int> nextSlot(upOffsets.begin(), upOffsets.end() - 1);
+	for(int i = 0; i < (int)arcs.size(); i++){
+		const arcT &arc = arcs[i];
+		if(arc.endA == arc.endB) continue;
+		int lower = (rank[arc.endA] < rank[arc.endB]) ? arc.endA : arc.endB;
+		int slot = nextSlot[lower]++;
+		upTargets[slot] = otherEnd(arc, lower);
+		upCosts[slot] = arc.cost;
+		upArcs[slot] = i;
+	}
+
+	forward.distances.assign(nodeCount, std::numeric_limits<double>::infinity());
+	forward.predecessorArcs.assign(nodeCount, -1);
+	forward.touched.clear();
+	forward.frontier.reserve(nodeCount);
+	backward = forward;
+	backward.frontier.reserve(nodeCount);
+	pathStart = meetingNode = -1;
+	built = true;
+}
+
+bool ContractionHierarchy::isBuilt(){
+	return built;
+}
+
+int ContractionHierarchy::numShortcuts(){
+	return arcs.size() - linkCount;
+}
+
+searchStatsT ContractionHierarchy::getStats(){
+	searchStatsT result = stats;
+	addStats(result, forward.frontier.getStats());
+	addStats(result, backward.frontier.getStats());
+	return result;
+}
+
+/*
+* Implementation notes : findShortestPath
+* ----------------------------------------
+* The two upward searches take turns. A side stops once the smallest
+* key on its frontier is no less than the cheapest meeting found so far,
+* since anything it settles from then on can't make a cheaper one.
+*/
+bool ContractionHierarchy::findShortestPath(int start, int end){
+	COUNT_STAT(stats = NO_SEARCH_STATS);
+	COUNT_STAT(forward.frontier.clearStats());
+	COUNT_STAT(backward.frontier.clearStats());
+	resetLabels(forward);
+	resetLabels(backward);
+	pathStart = start;
+	meetingNode = -1;
+	pathCost = std::numeric_limits<double>::infinity();
+	label(forward, start, 0, -1);
+	label(backward, end, 0, -1);
+	forward.frontier.enqueue(start, 0);
+	backward.frontier.enqueue(end, 0);
+
+	bool fromStart = true;
+	while(true){
+		bool forwardDone = forward.frontier.isEmpty() || forward.frontier.peekMinKey() >= pathCost;
+		bool backwardDone = backward.frontier.isEmpty() || backward.frontier.peekMinKey() >= pathCost;
+		if(forwardDone && backwardDone) break;
+		if(forwardDone) fromStart = false;
+		else if(backwardDone) fromStart = true;
+		if(fromStart) settleUpwards(forward, backward);
+		else settleUpwards(backward, forward);
+		fromStart = !fromStart;
+	}
+	return meetingNode != -1;
+}
+
+void ContractionHierarchy::settleUpwards(queryLabelsT &side, queryLabelsT &otherSide){
+	int current = side.frontier.dequeueMin();
+	double currentDistance = side.distances[current];
+	COUNT_STAT(stats.nodesSettled++);
+	COUNT_STAT(stats.edgesRelaxed += upOffsets[current + 1] - upOffsets[current]);
+	double meetingCost = currentDistance + otherSide.distances[current];
+	if(meetingCost < pathCost){
+		pathCost = meetingCost;
+		meetingNode = current;
+	}
+	for(int edge = upOffsets[current]; edge < upOffsets[current + 1]; edge++){
+		int neighbor = upTargets[edge];
+		double newDistance = currentDistance + upCosts[edge];
+		if(newDistance >= side.distances[neighbor]) continue;
+		if(side.frontier.contains(neighbor)) side.frontier.decreaseKey(neighbor, newDistance);
+		else side.frontier.enqueue(neighbor, newDistance);
+		label(side, neighbor, newDistance, upArcs[edge]);
+	}
+}
+
+void ContractionHierarchy::resetLabels(queryLabelsT &labels){
+	for(int i = 0; i < (int)labels.touched.size(); i++){
+		int node = labels.touched[i];
+		labels.distances[node] = std::numeric_limits<double>::infinity();
+		labels.predecessorArcs[node] = -1;
+	}
+	labels.touched.clear();
+	labels.frontier.clear();
+}
+
+void ContractionHierarchy::label(queryLabelsT &labels, int node, double distance, int arcId){
+	if(labels.distances[node] == std::numeric_limits<double>::infinity()){
+		COUNT_STAT(if(labels.touched.size() == labels.touched.capacity()) stats.allocations++);
+		labels.touched.push_back(node);
+	}
+	labels.distances[node] = distance;
+	labels.predecessorArcs[node] = arcId;
+}
+
+double ContractionHierarchy::getPathCost(){
+	return pathCost;
+}
+
+void ContractionHierarchy::getPathLinks(std::vector<int> &linkIds){
+	linkIds.clear();
+	if(meetingNode == -1) return;
+
+	// Start to meeting node: the forward arcs walked back, then reversed
+	std::vector<int> pathArcs, arcStarts;
+	int current = meetingNode;
+	while(forward.predecessorArcs[current] != -1){
+		int arcId = forward.predecessorArcs[current];
+		current = otherEnd(arcs[arcId], current);
+		pathArcs.push_back(arcId);
+		arcStarts.push_back(current);
+	}
+	std::reverse(pathArcs.begin(), pathArcs.end());
+	std::reverse(arcStarts.begin(), arcStarts.end());
+	for(int i = 0; i < (int)pathArcs.size(); i++)
+		unpackArc(pathArcs[i], arcStarts[i], linkIds);
+
+	// Meeting node to end: the backward arcs in the order they are walked
+	current = meetingNode;
+	while(backward.predecessorArcs[current] != -1){
+		int arcId = backward.predecessorArcs[current];
+		unpackArc(arcId, current, linkIds);
+		current = otherEnd(arcs[arcId], current);
+	}
+}
+
+// Appends the original links an arc stands for, in order from fromNode
+void ContractionHierarchy::unpackArc(int arcId, int fromNode, std::vector<int> &linkIds){
+	const arcT &arc = arcs[arcId];
+	if(arc.childA == -1){
+		linkIds.push_back(arcId);
+	}else if(fromNode == arc.endA){
+		unpackArc(arc.childA, arc.endA, linkIds);
+		unpackArc(arc.childB, arc.middle, linkIds);
+	}else{
+		unpackArc(arc.childB, arc.endB, linkIds);
+		unpackArc(arc.childA, arc.middle, linkIds);
+	}
+}
+
+/*
+* ****************Saved Hierarchy Format******************
+* header (hierarchyHeaderT)
+* rank   numNodes x int
+* arcs   numArcs  x (int endA, int endB, double cost, int middle,
+*                   int childA, int childB), 28 bytes each
+* Laid out like a compiled chart (see chartbinary.h), every section
+* starts on a multiple of 8 bytes. The arcs are written field by field
+* so that no padding byte of arcT ends up in the file.
+*/
+const int SAVED_ARC_SIZE = 5 * sizeof(int) + sizeof(double);
+
+// Copies one field of a saved arc out of the file and moves past it
+template <typename FieldType>
+void readField(const char * &field, FieldType &value){
+	memcpy(&value, field, sizeof(value));
+	field += sizeof(value);
+}
+
+bool ContractionHierarchy::save(string fileName, string sourceFileName){
+	if(!built) return false;
+	hierarchyHeaderT header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, HIERARCHY_MAGIC, sizeof(header.magic));
+	header.version = HIERARCHY_VERSION;
+	header.byteOrderMark = BYTE_ORDER_MARK;
+	if(!getSourceStamp(sourceFileName, header.sourceSize, header.sourceModified)) return false;
+	header.numNodes = nodeCount;
+	header.numLinks = linkCount;
+	header.numArcs = arcs.size();
+
+	string tempFileName = fileName + ".tmp";
+	FILE * file = fopen(tempFileName.c_str(), "wb");
+	if(file == NULL) return false;
+	writeSection(file, &header, 1);
+	writeSection(file, rank.empty() ? NULL : &rank[0], rank.size());
+	for(int i = 0; i < (int)arcs.size(); i++){
+		const arcT &arc = arcs[i];
+		fwrite(&arc.endA, sizeof(int), 1, file);
+		fwrite(&arc.endB, sizeof(int), 1, file);
+		fwrite(&arc.cost, sizeof(double), 1, file);
+		fwrite(&arc.middle, sizeof(int), 1, file);
+		fwrite(&arc.childA, sizeof(int), 1, file);
+		fwrite(&arc.childB, sizeof(int), 1, file);
+	}
+	long arcBytes = (long)arcs.size() * SAVED_ARC_SIZE;
+	static const char padding[8] = {0};
+	fwrite(padding, 1, alignSection(arcBytes) - arcBytes, file);
+	bool written = (ferror(file) == 0);
+	written = (fclose(file) == 0) && written;
+	remove(fileName.c_str());
+	if(!written || rename(tempFileName.c_str(), fileName.c_str()) != 0){
+		remove(tempFileName.c_str());
+		return false;
+	}
+	return true;
+}
+
+bool ContractionHierarchy::load(string fileName, string sourceFileName, const CSRGraph &graph){
+	built = false;
+	MappedFile file;
+	if(!file.open(fileName)) return false;
+	const char * cursor = file.getData();
+	const char * end = cursor + file.getSize();
+	if(file.getSize() < (long)sizeof(hierarchyHeaderT)) return false;
+	hierarchyHeaderT header;
+	memcpy(&header, cursor, sizeof(header));
+	cursor += alignSection(sizeof(header));
+	if(memcmp(header.magic, HIERARCHY_MAGIC, sizeof(header.magic)) != 0) return false;
+	if(header.version != HIERARCHY_VERSION || header.byteOrderMark != BYTE_ORDER_MARK) return false;
+	if(header.numNodes != graph.numNodes() || header.numLinks != graph.numLinks()) return false;
+	if(header.numArcs < header.numLinks) return false;
+
+	long long sourceSize, sourceModified;
+	if(getSourceStamp(sourceFileName, sourceSize, sourceModified)){
+		if(sourceSize != header.sourceSize || sourceModified != header.sourceModified) return false;
+	}
+	std::vector<char> arcBytes;
+	if(!readSection(cursor, end, rank, header.numNodes)
+		|| !readSection(cursor, end, arcBytes, (long)header.numArcs * SAVED_ARC_SIZE)){
+		rank.clear();
+		return false;
+	}
+	arcs.resize(header.numArcs);
+	const char * field = arcBytes.empty() ? NULL : &arcBytes[0];
+	for(int i = 0; i < header.numArcs; i++){
+		arcT &arc = arcs[i];
+		readField(field, arc.endA);
+		readField(field, arc.endB);
+		readField(field, arc.cost);
+		readField(field, arc.middle);
+		readField(field, arc.childA);
+		readField(field, arc.childB);
+	}
+	// The original links must be the graph's own
+	bool fits = true;
+	for(int i = 0; fits && i < header.numLinks; i++){
+		fits = arcs[i].endA == graph.getLinkStart(i) && arcs[i].endB == graph.getLinkEnd(i)
+			&& arcs[i].cost == graph.getLinkCost(i) && arcs[i].childA == -1;
+	}
+	nodeCount = header.numNodes;
+	linkCount = header.numLinks;
+	if(!fits || !isWellFormed()){
+		rank.clear();
+		arcs.clear();
+		return false;
+	}
+	buildUpwardGraph();
+	return true;
+}
+
+/*
+* Implementation notes : isWellFormed
+* ------------------------------------
+* Checks what queries take on trust in a loaded hierarchy: rank is a
+* permutation of the node ids, and every shortcut has its ends and
+* middle in range, a cost that isn't negative, and is made of two arcs
+* that come before it and join its ends to its middle. Children coming
+* first is what ends the recursion of unpackArc.
+*/
+bool ContractionHierarchy::isWellFormed(){
+	std::vector<bool> ranked(nodeCount, false);
+	for(int node = 0; node < nodeCount; node++){
+		if(rank[node] < 0 || rank[node] >= nodeCount || ranked[rank[node]]) return false;
+		ranked[rank[node]] = true;
+	}
+	for(int i = linkCount; i < (int)arcs.size(); i++){
+		const arcT &arc = arcs[i];
+		if(arc.endA < 0 || arc.endA >= nodeCount || arc.endB < 0 || arc.endB >= nodeCount) return false;
+		if(arc.middle < 0 || arc.middle >= nodeCount || !(arc.cost >= 0)) return false;
+		if(arc.childA < 0 || arc.childA >= i || arc.childB < 0 || arc.childB >= i) return false;
+		if(!joins(arc.childA, arc.endA, arc.middle) || !joins(arc.childB, arc.middle, arc.endB)) return false;
+	}
+	return true;
+}
+
+// True if the arc joins the two nodes, either way round
+bool ContractionHierarchy::joins(int arcId, int one, int two){
+	const arcT &arc = arcs[arcId];
+	return (arc.endA == one && arc.endB == two) || (arc.endA == two && arc.endB == one);
+}
+
+#endif
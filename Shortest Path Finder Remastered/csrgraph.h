@@ -0,0 +1,402 @@
+/*
+* File : csrgraph.h
+* ------------------
+* Defines the CSRGraph class, the positions and links of a chart laid
+* out in compressed sparse row form. Positions are known only by their
+* ids (0 to numNodes-1) and links by their ids (0 to numLinks-1), the
+* index they have in the chart's list of links.
+*
+* Since links have no direction every link shows up twice in the
+* adjacency, once as an edge leaving each of its ends. The edges leaving
+* node u are the ones numbered firstEdge(u) up to but not including
+* endEdge(u), and for each of them the node on the other end, the cost
+* and the id of the link it came from sit in three contiguous arrays.
+* The links are also kept as a flat list for algorithms like Kruskal's
+* that want to look at every link once.
+*
+* Building the graph also notes whether every cost is a whole number
+* that fits in 32 bits, as on all the bundled charts, which lets
+* searches use a RadixHeap (see searchfrontier.h). Costs are still kept
+* as doubles: sums of whole numbers are exact in a double up to 2^53,
+* far beyond any path on a chart.
+*
+* Links can be added, removed and given a new cost once the graph is
+* built, see addLink. A removed link keeps its id, it just has no edges
+* any more and isLinkRemoved says so, so the ids of the other links and
+* everything indexed by them stay as they were.
+*
+* Implementation notes
+* ---------------------
+* As built, the edges of every node fill the slots up to those of the
+* next node. Past that each node has an end and a limit of its own: a
+* removed edge is swapped with the last edge of its node and the end
+* moves down, an added edge goes in at the end if the node has room
+* left. If it hasn't, the edges of the node are moved to fresh slots at
+* the back of the arrays with room for twice as many, and the slots they
+* leave are never used again. Room only ever doubles, so the slots left
+* behind add up to less than the room in use.
+*/
+
+#ifndef CSR_GRAPH_H
+#define CSR_GRAPH_H
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+const double MAX_INTEGER_COST = 4294967295.0;
+
+// Slots given to a node that runs out of room and has few edges
+const int MIN_EDGE_ROOM = 4;
+
+class CSRGraph{
+public:
+	/*
+	* Function : Constructor function for the CSRGraph class
+	* Usage    : CSRGraph graph;
+	* -------------------------------------------------------
+	* Creates an empty graph, fill it in with build.
+	*/
+	CSRGraph();
+
+	/*
+	* Function : build
+	* Usage    : graph.build(numPositions, linkStarts, linkEnds, linkCosts);
+	* ----------------------------------------------------------------------
+	* Builds the snapshot from a list of links, link i connects the
+	* nodes linkStarts[i] and linkEnds[i] at the cost linkCosts[i].
+	* Anything built before is thrown away.
+	*/
+	void build(int numPositions, const std::vector<int> &linkStarts,
+		const std::vector<int> &linkEnds, const std::vector<double> &linkCostList);
+
+	/*
+	* Function : assign
+	* Usage    : graph.assign(numPositions, linkStarts, linkEnds, linkCosts, offsets, targets, edgeLinks);
+	* -----------------------------------------------------------------------------------------------
+	* Same as build for a layout that was worked out before, e.g. read 
+	* back from a compiled chart, so the counting sort is skipped. The 
+	* last three arguments are the offsets, targets and link ids arrays 
+	* as build would have made them.
+	*/
+	void assign(int numPositions, const std::vector<int> &linkStarts,
+		const std::vector<int> &linkEnds, const std::vector<double> &linkCostList,
+		const std::vector<int> &edgeOffsets, const std::vector<int> &edgeTargets,
+		const std::vector<int> &edgeLinkIds);
+
+	int numNodes() const;
+	int numLinks() const;
+
+	/*
+	* Function : firstEdge, endEdge
+	* Usage    : for(int e = graph.firstEdge(u); e < graph.endEdge(u); e++) ...
+	* ---------------------------------------------------------------------------
+	* Bound the range of edges leaving the given node.
+	*/
+	int firstEdge(int node) const;
+	int endEdge(int node) const;
+
+	/*
+	* Function : getTarget, getCost, getLinkId
+	* Usage    : int v = graph.getTarget(e);
+	* ---------------------------------------
+	* Return the node an edge leads to, the cost of crossing it and
+	* the id of the link the edge stands for.
+	*/
+	int getTarget(int edge) const;
+	double getCost(int edge) const;
+	int getLinkId(int edge) const;
+
+	/*
+	* Function : getLinkStart, getLinkEnd, getLinkCost
+	* Usage    : int u = graph.getLinkStart(linkId);
+	* -----------------------------------------------
+	* Access to the flat list of links the graph was built from.
+	*/
+	int getLinkStart(int linkId) const;
+	int getLinkEnd(int linkId) const;
+	double getLinkCost(int linkId) const;
+
+	/*
+	* Function : hasIntegerCosts
+	* Usage    : if(graph.hasIntegerCosts()) ...
+	* -------------------------------------------
+	* True if every link costs a whole number from 0 to MAX_INTEGER_COST.
+	*/
+	bool hasIntegerCosts() const;
+
+	/*
+	* Function : addLink
+	* Usage    : int linkId = graph.addLink(startId, endId, cost);
+	* -----------------------------------------------------------
+	* Adds a link between two nodes and returns its id, numLinks()-1.
+	* Takes time proportional to the number of links at its ends.
+	*/
+	int addLink(int start, int end, double cost);
+
+	/*
+	* Function : removeLink
+	* Usage    : graph.removeLink(linkId);
+	* -------------------------------------
+	* Takes the edges of the link out of the graph. The link keeps its
+	* id, ends and cost in the flat list, it is only marked as removed.
+	*/
+	void removeLink(int linkId);
+
+	/*
+	* Function : setLinkCost
+	* Usage    : graph.setLinkCost(linkId, newCost);
+	* -----------------------------------------------
+	* Gives a link that isn't removed a new cost.
+	*/
+	void setLinkCost(int linkId, double cost);
+
+	/*
+	* Function : isLinkRemoved, numRemovedLinks
+	* Usage    : if(graph.isLinkRemoved(linkId)) continue;
+	* -----------------------------------------------------
+	* Code going over the flat list of links skips the removed ones.
+	*/
+	bool isLinkRemoved(int linkId) const;
+	int numRemovedLinks() const;
+
+	/*
+	* Function : numEdgeSlots
+	* Usage    : std::vector<Link* > edgeLinks(graph.numEdgeSlots());
+	* --------------------------------------------------------------
+	* One more than the highest edge number in use, for arrays that are
+	* indexed by edge. Grows when a node with no room left gains a link.
+	*/
+	int numEdgeSlots() const;
+
+private:
+	int nodeCount;
+	std::vector<int> offsets;      // first edge of every node, numNodes+1 entries
+	std::vector<int> edgeEnds;     // end of the edges of every node
+	std::vector<int> edgeLimits;   // end of the room of every node
+	std::vector<int> targets;      // one entry per edge slot
+	std::vector<double> costs;     // one entry per edge slot
+	std::vector<int> edgeLinks;    // one entry per edge slot
+	std::vector<int> starts;       // one entry per link
+	std::vector<int> ends;         // one entry per link
+	std::vector<double> linkCosts; // one entry per link
+	std::vector<bool> removed;     // one entry per link
+	int removedCount;
+	int fractionalCount;           // links that are not removed and don't have an integer cost
+
+	void finishBuild();
+	void insertEdge(int node, int target, double cost, int linkId);
+	void removeEdge(int node, int linkId);
+	void moveToRoom(int node);
+	static bool isIntegerCost(double cost);
+};
+
+CSRGraph::CSRGraph(){
+	nodeCount = 0;
+	offsets.assign(1, 0);
+	removedCount = fractionalCount = 0;
+}
+
+/*
+* Implementation notes : build
+* -----------------------------
+* A counting sort on the edges: count the degree of every node, turn
+* the counts into offsets by a running sum and then drop every edge
+* into the next free slot of its node.
+*/
+void CSRGraph::build(int numPositions, const std::vector<int> &linkStarts,
+	const std::vector<int> &linkEnds, const std::vector<double> &linkCostList){
+	nodeCount = numPositions;
+	starts = linkStarts;
+	ends = linkEnds;
+	linkCosts = linkCostList;
+
+	int linkCount = starts.size();
+	offsets.assign(nodeCount + 1, 0);
+	for(int i = 0; i < linkCount; i++){
+		offsets[starts[i] + 1]++;
+		offsets[ends[i] + 1]++;
+	}
+	for(int node = 0; node < nodeCount; node++)
+		offsets[node + 1] += offsets[node];
+
+	int numEdges = 2 * linkCount;
+	targets.resize(numEdges);
+	costs.resize(numEdges);
+	edgeLinks.resize(numEdges);
+	std::vector<int> nextSlot(offsets.begin(), offsets.end() - 1);
+	for(int i = 0; i < linkCount; i++){
+		int slot = nextSlot[starts[i]]++;
+		targets[slot] = ends[i];
+		costs[slot] = linkCosts[i];
+		edgeLinks[slot] = i;
+
+		slot = nextSlot[ends[i]]++;
+		targets[slot] = starts[i];
+		costs[slot] = linkCosts[i];
+		edgeLinks[slot] = i;
+	}
+	finishBuild();
+}
+
+void CSRGraph::assign(int numPositions, const std::vector<int> &linkStarts,
+	const std::vector<int> &linkEnds, const std::vector<double> &linkCostList,
+	const std::vector<int> &edgeOffsets, const std::vector<int> &edgeTargets,
+	const std::vector<int> &edgeLinkIds){
+	nodeCount = numPositions;
+	starts = linkStarts;
+	ends = linkEnds;
+	linkCosts = linkCostList;
+	offsets = edgeOffsets;
+	targets = edgeTargets;
+	edgeLinks = edgeLinkIds;
+	costs.resize(edgeLinks.size());
+	for(int edge = 0; edge < (int)edgeLinks.size(); edge++)
+		costs[edge] = linkCosts[edgeLinks[edge]];
+	finishBuild();
+}
+
+int CSRGraph::numNodes() const{
+	return nodeCount;
+}
+
+int CSRGraph::numLinks() const{
+	return starts.size();
+}
+
+int CSRGraph::firstEdge(int node) const{
+	return offsets[node];
+}
+
+int CSRGraph::endEdge(int node) const{
+	return edgeEnds[node];
+}
+
+int CSRGraph::getTarget(int edge) const{
+	return targets[edge];
+}
+
+double CSRGraph::getCost(int edge) const{
+	return costs[edge];
+}
+
+int CSRGraph::getLinkId(int edge) const{
+	return edgeLinks[edge];
+}
+
+int CSRGraph::getLinkStart(int linkId) const{
+	return starts[linkId];
+}
+
+int CSRGraph::getLinkEnd(int linkId) const{
+	return ends[linkId];
+}
+
+double CSRGraph::getLinkCost(int linkId) const{
+	return linkCosts[linkId];
+}
+
+bool CSRGraph::hasIntegerCosts() const{
+	return fractionalCount == 0;
+}
+
+int CSRGraph::addLink(int start, int end, double cost){
+	int linkId = starts.size();
+	starts.push_back(start);
+	ends.push_back(end);
+	linkCosts.push_back(cost);
+	removed.push_back(false);
+	if(!isIntegerCost(cost)) fractionalCount++;
+	insertEdge(start, end, cost, linkId);
+	insertEdge(end, start, cost, linkId);
+	return linkId;
+}
+
+void CSRGraph::removeLink(int linkId){
+	if(removed[linkId]) return;
+	removeEdge(starts[linkId], linkId);
+	removeEdge(ends[linkId], linkId);
+	removed[linkId] = true;
+	removedCount++;
+	if(!isIntegerCost(linkCosts[linkId])) fractionalCount--;
+}
+
+// Both ends are scanned for the edges of the link, a link from a node to itself has both at one
+void CSRGraph::setLinkCost(int linkId, double cost){
+	if(!isIntegerCost(linkCosts[linkId])) fractionalCount--;
+	if(!isIntegerCost(cost)) fractionalCount++;
+	linkCosts[linkId] = cost;
+	int linkEnds[2] = {starts[linkId], ends[linkId]};
+	for(int i = 0; i < 2; i++)
+		for(int edge = offsets[linkEnds[i]]; edge < edgeEnds[linkEnds[i]]; edge++)
+			if(edgeLinks[edge] == linkId) costs[edge] = cost;
+}
+
+bool CSRGraph::isLinkRemoved(int linkId) const{
+	return removed[linkId];
+}
+
+int CSRGraph::numRemovedLinks() const{
+	return removedCount;
+}
+
+int CSRGraph::numEdgeSlots() const{
+	return targets.size();
+}
+
+// Every node's edges run up to the next node's, and no link is removed yet
+void CSRGraph::finishBuild(){
+	edgeEnds.assign(offsets.begin() + 1, offsets.end());
+	edgeLimits = edgeEnds;
+	removed.assign(starts.size(), false);
+	removedCount = 0;
+	fractionalCount = 0;
+	for(int linkId = 0; linkId < (int)linkCosts.size(); linkId++)
+		if(!isIntegerCost(linkCosts[linkId])) fractionalCount++;
+}
+
+void CSRGraph::insertEdge(int node, int target, double cost, int linkId){
+	if(edgeEnds[node] == edgeLimits[node]) moveToRoom(node);
+	int slot = edgeEnds[node]++;
+	targets[slot] = target;
+	costs[slot] = cost;
+	edgeLinks[slot] = linkId;
+}
+
+// The last edge of the node takes the place of the one removed
+void CSRGraph::removeEdge(int node, int linkId){
+	int last = edgeEnds[node] - 1;
+	for(int edge = offsets[node]; edge <= last; edge++){
+		if(edgeLinks[edge] != linkId) continue;
+		targets[edge] = targets[last];
+		costs[edge] = costs[last];
+		edgeLinks[edge] = edgeLinks[last];
+		edgeEnds[node]--;
+		return;
+	}
+}
+
+// Moves the edges of the node to the back of the arrays with room for twice as many
+void CSRGraph::moveToRoom(int node){
+	int first = offsets[node];
+	int degree = edgeEnds[node] - first;
+	int room = std::max(2 * degree, MIN_EDGE_ROOM);
+	int newFirst = targets.size();
+	targets.resize(newFirst + room);
+	costs.resize(newFirst + room);
+	edgeLinks.resize(newFirst + room);
+	for(int i = 0; i < degree; i++){
+		targets[newFirst + i] = targets[first + i];
+		costs[newFirst + i] = costs[first + i];
+		edgeLinks[newFirst + i] = edgeLinks[first + i];
+	}
+	offsets[node] = newFirst;
+	edgeEnds[node] = newFirst + degree;
+	edgeLimits[node] = newFirst + room;
+}
+
+bool CSRGraph::isIntegerCost(double cost){
+	return cost >= 0 && cost <= MAX_INTEGER_COST && std::floor(cost) == cost;
+}
+
+#endif
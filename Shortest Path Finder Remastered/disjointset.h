@@ -0,0 +1,110 @@
+/*
+* File : disjointset.h
+* ---------------------
+* Defines the DisjointSet class (also known as union-find) which keeps
+* the ids 0 to size-1 split into a number of non overlapping sets.
+* Initially every id is a set on its own, two sets can be merged with
+* unite and find tells which set an id currently belongs to by returning
+* the representative id of that set.
+*
+* Implementation notes
+* ---------------------
+* Every set is a tree stored through parent links. Union by rank keeps the
+* trees shallow and find compresses the path it walks by pointing every
+* other node at its grandparent (path halving), together that makes both
+* operations run in practically constant amortized time.
+*/
+
+#ifndef DISJOINT_SET_H
+#define DISJOINT_SET_H
+
+#include <vector>
+
+class DisjointSet{
+public:
+	/*
+	* Function : Constructor function for the DisjointSet class
+	* Usage    : DisjointSet sets(numPositions);
+	* ----------------------------------------------------------
+	* Creates size singleton sets for the ids 0 to size-1.
+	*/
+	DisjointSet(int size = 0);
+
+	/*
+	* Function : reset
+	* Usage    : sets.reset(size);
+	* ------------------------------
+	* Forgets all unions and starts again with size singleton sets.
+	*/
+	void reset(int size);
+
+	/*
+	* Function : find
+	* Usage    : int representative = sets.find(id);
+	* ----------------------------------------------
+	* Returns the representative of the set containing id, two ids are
+	* in the same set exactly when find returns the same value for them.
+	*/
+	int find(int id);
+
+	/*
+	* Function : unite
+	* Usage    : if(sets.unite(id1, id2)) ...
+	* ----------------------------------------
+	* Merges the sets containing the two ids. Returns false if they
+	* already were in the same set and true if a merge took place.
+	*/
+	bool unite(int id1, int id2);
+
+	/*
+	* Function : numSets
+	* Usage    : int components = sets.numSets();
+	* -------------------------------------------
+	*/
+	int numSets();
+
+private:
+	std::vector<int> parent;
+	std::vector<unsigned char> rank;
+	int setCount;
+};
+
+DisjointSet::DisjointSet(int size){
+	reset(size);
+}
+
+void DisjointSet::reset(int size){
+	parent.resize(size);
+	for(int i = 0; i < size; i++) parent[i] = i;
+	rank.assign(size, 0);
+	setCount = size;
+}
+
+int DisjointSet::find(int id){
+	while(parent[id] != id){
+		parent[id] = parent[parent[id]];
+		id = parent[id];
+	}
+	return id;
+}
+
+bool DisjointSet::unite(int id1, int id2){
+	int root1 = find(id1);
+	int root2 = find(id2);
+	if(root1 == root2) return false;
+	if(rank[root1] < rank[root2]){
+		int temp = root1;
+		root1 = root2;
+		root2 = temp;
+	}
+	parent[root2] = root1;
+	if(rank[root1] == rank[root2]) rank[root1]++;
+	setCount--;
+	return true;
+}
+
+int DisjointSet::numSets(){
+	return setCount;
+}
+
+#endif
@@ -0,0 +1,141 @@
+/*
+* File : distancematrix.h
+* ------------------------
+* Defines the DistanceMatrix class which works out the cost of the
+* cheapest path from every one of a list of sources to every one of a
+* list of targets in a single call.
+*
+* Implementation notes
+* ---------------------
+* Every source gets its own one to many Dijkstra (see
+* PathFinder::findDistancesFrom) that stops once all the targets are
+* settled. The searches don't depend on each other, so they are handed
+* out to the threads of an OpenMP team one source at a time, whichever
+* thread is free takes the next. Each thread has a PathFinder of its own
+* that is sized for the graph once and reused for every source it takes,
+* so the threads share nothing but the read only graph and write to
+* separate rows of the result. Built without OpenMP the same loop simply
+* runs on one thread.
+*/
+
+#ifndef DISTANCE_MATRIX_H
+#define DISTANCE_MATRIX_H
+
+#include <vector>
+#include <algorithm>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "csrgraph.h"
+#include "pathfinder.h"
+
+class DistanceMatrix{
+public:
+	/*
+	* Function : Constructor function for the DistanceMatrix class
+	* Usage    : DistanceMatrix matrix(&graph);
+	* ----------------------------------------------------------
+	* The graph is not copied and must outlive the DistanceMatrix.
+	*/
+	DistanceMatrix(const CSRGraph * searchGraph = NULL);
+
+	/*
+	* Function : setGraph
+	* Usage    : matrix.setGraph(&graph);
+	* ------------------------------------
+	* Points the matrix at a (new) graph, the scratch space of the
+	* threads is sized for it on the next compute.
+	*/
+	void setGraph(const CSRGraph * searchGraph);
+
+	/*
+	* Function : compute
+	* Usage    : matrix.compute(sourceIds, targetIds, costs);
+	* --------------------------------------------------------
+	* Fills costs with numSources x numTargets entries, row by row: the
+	* cost from sources[i] to targets[j] is costs[i * numTargets + j],
+	* INFINITE_DISTANCE if targets[j] can't be reached from sources[i].
+	*/
+	void compute(const std::vector<int> &sources, const std::vector<int> &targets, std::vector<double> &costs);
+
+	/*
+	* Function : numThreads
+	* Usage    : int n = matrix.numThreads();
+	* ----------------------------------------
+	* The number of searches compute runs at the same time.
+	*/
+	int numThreads();
+
+	/*
+	* Function : getStats
+	* Usage    : searchStatsT stats = matrix.getStats();
+	* ---------------------------------------------------
+	* The work of all the searches of the last compute added up, all
+	* zero unless compiled with COLLECT_SEARCH_STATS (see searchstats.h).
+	*/
+	searchStatsT getStats();
+
+private:
+	const CSRGraph * graph;
+	std::vector<PathFinder> finders;            // one per thread
+	std::vector<std::vector<double> > rows;     // one per thread
+	std::vector<searchStatsT> threadStats;      // one per thread
+};
+
+DistanceMatrix::DistanceMatrix(const CSRGraph * searchGraph){
+	graph = searchGraph;
+}
+
+void DistanceMatrix::setGraph(const CSRGraph * searchGraph){
+	graph = searchGraph;
+	finders.clear();
+	rows.clear();
+}
+
+int DistanceMatrix::numThreads(){
+#ifdef _OPENMP
+	return omp_get_max_threads();
+#else
+	return 1;
+#endif
+}
+
+searchStatsT DistanceMatrix::getStats(){
+	searchStatsT result = NO_SEARCH_STATS;
+	for(int i = 0; i < (int)threadStats.size(); i++)
+		addStats(result, threadStats[i]);
+	return result;
+}
+
+void DistanceMatrix::compute(const std::vector<int> &sources, const std::vector<int> &targets, std::vector<double> &costs){
+	COUNT_STAT(threadStats.assign(numThreads(), NO_SEARCH_STATS));
+	int numSources = sources.size();
+	int numTargets = targets.size();
+	costs.assign((long)numSources * numTargets, INFINITE_DISTANCE);
+	if(numSources == 0 || numTargets == 0) return;
+
+	int threadCount = std::min(numThreads(), numSources);
+	if((int)finders.size() < threadCount){
+		finders.resize(threadCount);
+		rows.resize(threadCount);
+		for(int i = 0; i < threadCount; i++)
+			if(finders[i].getGraph() != graph) finders[i].setGraph(graph);
+	}
+
+#ifdef _OPENMP
+	#pragma omp parallel for schedule(dynamic, 1) num_threads(threadCount)
+#endif
+	for(int i = 0; i < numSources; i++){
+#ifdef _OPENMP
+		int thread = omp_get_thread_num();
+#else
+		int thread = 0;
+#endif
+		std::vector<double> &row = rows[thread];
+		finders[thread].findDistancesFrom(sources[i], targets, row);
+		std::copy(row.begin(), row.end(), costs.begin() + (long)i * numTargets);
+		COUNT_STAT(addStats(threadStats[thread], finders[thread].getStats()));
+	}
+}
+
+#endif
@@ -0,0 +1,120 @@
+/*
+* File : extgraphrenderer.h
+* --------------------------
+* Defines the ExtGraphRenderer class, the ChartRenderer that draws the
+* chart in the graphics window using the facilities from extgraph. This
+* is the only part of the program that depends on the graphics library.
+* Found paths, spanning trees and areas within reach are drawn one link
+* at a time with a short pause in between so the user can see them grow.
+*/
+
+#ifndef EXTGRAPH_RENDERER_H
+#define EXTGRAPH_RENDERER_H
+
+#include "extgraph.h"
+#include "chartrenderer.h"
+
+/* Constants
+ * ----------
+ * A few program-wide constants concerning the graphical display.
+ */
+const int LabelFontSize = 9;          // for node name labels
+
+const string MAP_COLOR = "Gray";
+const string FINAL_PATH_COLOR = "Black";
+const string MST_COLOR = "Black";
+const string REACHABLE_COLOR = "Blue";
+
+const double PATH_LINK_PAUSE = 0.15;  // seconds between links of a path
+const double MST_LINK_PAUSE = 0.01;   // seconds between links of a tree
+
+class ExtGraphRenderer : public ChartRenderer{
+public:
+	void chartOpened(string imageFileName);
+	void positionAdded(Position * pos);
+	void linkAdded(Link * link);
+	void pathFound(Path &path);
+	void spanningTreeLinkFound(Link * link);
+	void reachableLinkFound(Link * link);
+
+private:
+	void drawFilledCircleWithLabel(coordT center, string color, string label = "");
+	void drawLineBetween(coordT start, coordT end, string color = "Black");
+	void colorLink(Link * link, string color);
+};
+
+void ExtGraphRenderer::chartOpened(string imageFileName){
+	SetWindowTitle("Shortest path finder/Nash Vail");
+	DrawNamedPicture(imageFileName);
+}
+
+void ExtGraphRenderer::positionAdded(Position * pos){
+	drawFilledCircleWithLabel(pos->getCoordinates(), MAP_COLOR, pos->getName());
+}
+
+void ExtGraphRenderer::linkAdded(Link * link){
+	drawLineBetween(link->getStart()->getCoordinates(), link->getEnd()->getCoordinates(), MAP_COLOR);
+}
+
+void ExtGraphRenderer::pathFound(Path &path){
+	for(int i = 0 ; i < path.lengthInLinks(); i++){
+		colorLink(path.getAt(i), FINAL_PATH_COLOR);
+		Pause(PATH_LINK_PAUSE);
+	}
+}
+
+void ExtGraphRenderer::spanningTreeLinkFound(Link * link){
+	Pause(MST_LINK_PAUSE);
+	colorLink(link, MST_COLOR);
+}
+
+void ExtGraphRenderer::reachableLinkFound(Link * link){
+	Pause(MST_LINK_PAUSE);
+	colorLink(link, REACHABLE_COLOR);
+}
+
+// Draws the link and both of its ends in the given color
+void ExtGraphRenderer::colorLink(Link * link, string color){
+	Position * start = link->getStart();
+	Position * end = link->getEnd();
+	drawLineBetween(start->getCoordinates(), end->getCoordinates(), color);
+	drawFilledCircleWithLabel(start->getCoordinates(), color, start->getName());
+	drawFilledCircleWithLabel(end->getCoordinates(), color, end->getName());
+}
+
+/* Function: DrawFilledCircleWithLabel
+ * Usage:  DrawFilledCircleWithLabel(center, "Green", "You are here");
+ * -------------------------------------------------------------------
+ * Uses facilities from extgraph to draw a circle filled with
+ * color specified. The circle is centered at the given coord has the
+ * specified radius.  A label is drawn to the right of the circle.
+ * You can leave off the last argument if no label is desired.
+ */
+void ExtGraphRenderer::drawFilledCircleWithLabel(coordT center, string color, string label){
+	MovePen(center.x + CircleRadius, center.y);
+	SetPenColor(color);
+	StartFilledRegion(1.0);
+	DrawArc(CircleRadius, 0, 360);
+	EndFilledRegion();
+	if (!label.empty()) {
+		MovePen(center.x + CircleRadius, center.y);
+		SetFont("Helvetica");
+		SetPointSize(LabelFontSize);
+		DrawTextString(label);
+	}
+}
+
+/* Function: DrawLineBetween
+ * Usage:  DrawLineBetween(coord1, coord2, "Black");
+ * -------------------------------------------------
+ * Uses facilities from extgraph to draw a line of the
+ * specified color between the two given coordinates.
+ */
+void ExtGraphRenderer::drawLineBetween(coordT start, coordT end, string color)
+{
+	SetPenColor(color);
+	MovePen(start.x, start.y);
+	DrawLine(end.x - start.x, end.y - start.y);
+}
+
+#endif
@@ -0,0 +1,321 @@
+/*
+* File : indexedheap.h
+* ---------------------
+* Defines the IndexedHeap class, a d-ary min heap over integer ids
+* (0 to capacity-1) where every id can be in the heap at most once.
+* The heap remembers where each id sits so the key of a queued id
+* can be lowered in place (decreaseKey) instead of queuing a
+* second copy, which is what Dijkstra wants.
+*
+* Implementation notes
+* ---------------------
+* The comparison is a functor type given as a template parameter so
+* the compiler can inline it, sifting is done with loops rather than
+* recursion and the storage is plain std::vector so that reserve() can
+* set the space apart once before a search begins.
+*
+* Every entry has Arity children (2, 4 or 8), the children of entry i
+* being Arity*i+1 to Arity*i+Arity. A wider heap is shallower, so
+* enqueue and decreaseKey, which Dijkstra does far more often than it
+* dequeues, climb fewer levels, while dequeueMin looks at more children
+* per level, all of them next to each other in memory. Timing whole
+* Dijkstra searches on generated charts of 200000 positions (see
+* benchmark.cpp) still put 2 a little ahead of 4 and 8: the frontier
+* of a search on a chart stays small enough to fit in cache whatever
+* the arity, so the extra comparisons per level aren't won back.
+*/
+
+#ifndef INDEXED_HEAP_H
+#define INDEXED_HEAP_H
+
+#include <vector>
+#include <functional>
+#include "genlib.h"
+#include "searchstats.h"
+
+const int DEFAULT_HEAP_ARITY = 2;
+
+template <typename KeyType, typename Compare = std::less<KeyType>, int Arity = DEFAULT_HEAP_ARITY>
+class IndexedHeap{
+public:
+	/*
+	* Function : Constructor function for the IndexedHeap class
+	* Usage    : IndexedHeap<double> heap(numIds);
+	* ---------------------------------------------------------
+	* Ids passed to the heap must lie in the range 0 to capacity-1.
+	*/
+	IndexedHeap(int capacity = 0);
+
+	/*
+	* Function : reserve
+	* Usage    : heap.reserve(numIds);
+	* ---------------------------------
+	* Makes room for ids 0 to capacity-1 so that no memory is
+	* allocated while the heap is in use. Empties the heap.
+	*/
+	void reserve(int capacity);
+
+	/*
+	* Function : enqueue
+	* Usage    : heap.enqueue(id, key);
+	* ----------------------------------
+	* Adds the id to the heap with the given key, the id must not
+	* already be in the heap.
+	*/
+	void enqueue(int id, KeyType key);
+
+	/*
+	* Function : decreaseKey
+	* Usage    : heap.decreaseKey(id, smallerKey);
+	* ---------------------------------------------
+	* Lowers the key of an id that is already in the heap.
+	*/
+	void decreaseKey(int id, KeyType key);
+
+	/*
+	* Function : changeKey
+	* Usage    : heap.changeKey(id, newKey);
+	* ---------------------------------------
+	* Sets the key of an id that is already in the heap, the new key
+	* may be larger or smaller than the old one.
+	*/
+	void changeKey(int id, KeyType key);
+
+	/*
+	* Function : contains
+	* Usage    : if(heap.contains(id)) ...
+	* -------------------------------------
+	*/
+	bool contains(int id);
+
+	/*
+	* Function : getKey
+	* Usage    : KeyType key = heap.getKey(id);
+	* -----------------------------------------
+	* Returns the current key of an id that is in the heap.
+	*/
+	KeyType getKey(int id);
+
+	/*
+	* Function : peekMinKey
+	* Usage    : KeyType smallest = heap.peekMinKey();
+	* ------------------------------------------------
+	* Returns the smallest key without removing anything. Calls Error
+	* if the heap is empty, as does dequeueMin.
+	*/
+	KeyType peekMinKey();
+
+	/*
+	* Function : dequeueMin
+	* Usage    : int id = heap.dequeueMin();
+	* ---------------------------------------
+	* Removes the id with the smallest key from the heap and returns it.
+	*/
+	int dequeueMin();
+
+	/*
+	* Function : remove
+	* Usage    : heap.remove(id);
+	* ----------------------------
+	* Takes an id that is in the heap out of it, whatever its key.
+	*/
+	void remove(int id);
+
+	/*
+	* Function : clear
+	* Usage    : heap.clear();
+	* -------------------------
+	* Empties the heap, costs time proportional to the number of
+	* ids left in it and not to the capacity.
+	*/
+	void clear();
+
+	int size();
+	bool isEmpty();
+
+	/*
+	* Function : getStats, clearStats
+	* Usage    : addStats(total, heap.getStats());
+	* ---------------------------------------------
+	* Pushes, pops, peak size, comparisons and growths of the heap since
+	* the last clearStats, all zero unless compiled with
+	* COLLECT_SEARCH_STATS (see searchstats.h).
+	*/
+	const searchStatsT & getStats();
+	void clearStats();
+
+private:
+	struct entryT{
+		KeyType key;
+		int id;
+	};
+	std::vector<entryT> entries;     // the heap itself, 0 based
+	std::vector<int> heapIndex;      // where each id sits in entries, -1 if absent
+	Compare cmp;
+	searchStatsT stats;
+
+	// Fails to compile unless Arity is at least 2, a heap of arity 1 is a list
+	typedef char arityAtLeastTwo[(Arity >= 2) ? 1 : -1];
+
+	void siftUp(int index);
+	void siftDown(int index);
+};
+
+template <typename KeyType, typename Compare, int Arity>
+IndexedHeap<KeyType, Compare, Arity>::IndexedHeap(int capacity){
+	stats = NO_SEARCH_STATS;
+	reserve(capacity);
+}
+
+template <typename KeyType, typename Compare, int Arity>
+void IndexedHeap<KeyType, Compare, Arity>::reserve(int capacity){
+	entries.clear();
+	entries.reserve(capacity);
+	heapIndex.assign(capacity, -1);
+}
+
+template <typename KeyType, typename Compare, int Arity>
+void IndexedHeap<KeyType, Compare, Arity>::enqueue(int id, KeyType key){
+	entryT entry = {key, id};
+	COUNT_STAT(if(entries.size() == entries.capacity()) stats.allocations++);
+	entries.push_back(entry);
+	heapIndex[id] = entries.size() - 1;
+	siftUp(entries.size() - 1);
+	COUNT_STAT(stats.heapPushes++);
+	COUNT_STAT(if((long long)entries.size() > stats.heapPeakSize) stats.heapPeakSize = entries.size());
+}
+
+template <typename KeyType, typename Compare, int Arity>
+void IndexedHeap<KeyType, Compare, Arity>::decreaseKey(int id, KeyType key){
+	int index = heapIndex[id];
+	entries[index].key = key;
+	siftUp(index);
+}
+
+template <typename KeyType, typename Compare, int Arity>
+void IndexedHeap<KeyType, Compare, Arity>::changeKey(int id, KeyType key){
+	int index = heapIndex[id];
+	COUNT_STAT(stats.comparisons++);
+	bool smaller = cmp(key, entries[index].key);
+	entries[index].key = key;
+	if(smaller) siftUp(index);
+	else siftDown(index);
+}
+
+template <typename KeyType, typename Compare, int Arity>
+bool IndexedHeap<KeyType, Compare, Arity>::contains(int id){
+	return heapIndex[id] != -1;
+}
+
+template <typename KeyType, typename Compare, int Arity>
+KeyType IndexedHeap<KeyType, Compare, Arity>::getKey(int id){
+	return entries[heapIndex[id]].key;
+}
+
+template <typename KeyType, typename Compare, int Arity>
+KeyType IndexedHeap<KeyType, Compare, Arity>::peekMinKey(){
+	if(entries.empty()) Error("peekMinKey called on an empty heap");
+	return entries[0].key;
+}
+
+template <typename KeyType, typename Compare, int Arity>
+int IndexedHeap<KeyType, Compare, Arity>::dequeueMin(){
+	if(entries.empty()) Error("dequeueMin called on an empty heap");
+	int minId = entries[0].id;
+	heapIndex[minId] = -1;
+	COUNT_STAT(stats.heapPops++);
+	entryT last = entries.back();
+	entries.pop_back();
+	if(!entries.empty()){
+		entries[0] = last;
+		heapIndex[last.id] = 0;
+		siftDown(0);
+	}
+	return minId;
+}
+
+// The last entry takes the place of the one removed and moves up or down from there
+template <typename KeyType, typename Compare, int Arity>
+void IndexedHeap<KeyType, Compare, Arity>::remove(int id){
+	int index = heapIndex[id];
+	heapIndex[id] = -1;
+	entryT last = entries.back();
+	entries.pop_back();
+	if(index == (int)entries.size()) return;
+	entries[index] = last;
+	heapIndex[last.id] = index;
+	siftUp(index);
+	siftDown(heapIndex[last.id]);
+}
+
+template <typename KeyType, typename Compare, int Arity>
+void IndexedHeap<KeyType, Compare, Arity>::clear(){
+	for(int i = 0; i < (int)entries.size(); i++)
+		heapIndex[entries[i].id] = -1;
+	entries.clear();
+}
+
+template <typename KeyType, typename Compare, int Arity>
+int IndexedHeap<KeyType, Compare, Arity>::size(){
+	return entries.size();
+}
+
+template <typename KeyType, typename Compare, int Arity>
+bool IndexedHeap<KeyType, Compare, Arity>::isEmpty(){
+	return entries.empty();
+}
+
+template <typename KeyType, typename Compare, int Arity>
+const searchStatsT & IndexedHeap<KeyType, Compare, Arity>::getStats(){
+	return stats;
+}
+
+template <typename KeyType, typename Compare, int Arity>
+void IndexedHeap<KeyType, Compare, Arity>::clearStats(){
+	stats = NO_SEARCH_STATS;
+}
+
+/*
+* Implementation notes : siftUp, siftDown
+* ----------------------------------------
+* Rather than swapping at every level the moving entry is held aside,
+* the entries it passes are shifted by one level and it is written
+* once into the hole where it comes to rest.
+*/
+template <typename KeyType, typename Compare, int Arity>
+void IndexedHeap<KeyType, Compare, Arity>::siftUp(int index){
+	entryT moving = entries[index];
+	while(index > 0){
+		int parentIndex = (index - 1) / Arity;
+		COUNT_STAT(stats.comparisons++);
+		if(!cmp(moving.key, entries[parentIndex].key)) break;
+		entries[index] = entries[parentIndex];
+		heapIndex[entries[index].id] = index;
+		index = parentIndex;
+	}
+	entries[index] = moving;
+	heapIndex[moving.id] = index;
+}
+
+template <typename KeyType, typename Compare, int Arity>
+void IndexedHeap<KeyType, Compare, Arity>::siftDown(int index){
+	int numEntries = entries.size();
+	entryT moving = entries[index];
+	while(true){
+		int firstChild = Arity * index + 1;
+		if(firstChild >= numEntries) break;
+		int endChild = (firstChild + Arity < numEntries) ? firstChild + Arity : numEntries;
+		int childIndex = firstChild;
+		for(int other = firstChild + 1; other < endChild; other++)
+			if(cmp(entries[other].key, entries[childIndex].key)) childIndex = other;
+		COUNT_STAT(stats.comparisons += endChild - firstChild);
+		if(!cmp(entries[childIndex].key, moving.key)) break;
+		entries[index] = entries[childIndex];
+		heapIndex[entries[index].id] = index;
+		index = childIndex;
+	}
+	entries[index] = moving;
+	heapIndex[moving.id] = index;
+}
+
+#endif
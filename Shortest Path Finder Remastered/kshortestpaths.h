@@ -0,0 +1,369 @@
+/*
+* File : kshortestpaths.h
+* ------------------------
+* Defines the KShortestPaths class which finds, between two nodes of a
+* CSRGraph, the K cheapest paths that never visit a node twice, in
+* order of cost, by Yen's algorithm: every accepted path is taken apart
+* node by node, and from each node (the spur node) a search looks for
+* the cheapest way on to the end that leaves the path there, along a
+* link no accepted path sharing the same start (the root) took next and
+* avoiding the nodes of the root. Root plus spur path is a candidate,
+* and the cheapest candidate not accepted yet is the next path.
+*
+* Implementation notes
+* ---------------------
+* Before anything else a Dijkstra search backwards from the end runs
+* until it settles the start, and every spur search is an A* guided by
+* it: the estimate of a node is its distance from the end if that
+* search settled it, and the distance from the start to the end (which
+* no unsettled node is nearer than) otherwise. Taking links or nodes
+* away never makes a node nearer the end, so the estimate stays a lower
+* bound that obeys the triangle inequality, and near the paths already
+* found it is exact, so a spur search mostly walks straight to the end.
+* The spur searches reuse one set of labels and one frontier, reset by
+* the list of nodes they touched, and block nodes and links by stamping
+* them with the number of the spur search, so nothing is cleared.
+* A candidate is kept as the accepted path it branches off, how many of
+* that path's links its root keeps, and its spur links, which go into
+* one pool shared by all the candidates. Only accepted paths are laid
+* out in full. As in Lawler's variant of Yen's algorithm an accepted
+* path is only taken apart from the node where it left the path it
+* branched off, the roots before that were tried for its parent.
+*/
+
+#ifndef K_SHORTEST_PATHS_H
+#define K_SHORTEST_PATHS_H
+
+#include <vector>
+#include <set>
+#include <algorithm>
+#include "csrgraph.h"
+#include "pathfinder.h"
+#include "searchfrontier.h"
+#include "searchstats.h"
+
+class KShortestPaths{
+public:
+	/*
+	* Function : Constructor function for the KShortestPaths class
+	* Usage    : KShortestPaths finder(&graph);
+	* ------------------------------------------------------
+	* The graph is not copied and must outlive the KShortestPaths.
+	*/
+	KShortestPaths(const CSRGraph * searchGraph = NULL);
+
+	/*
+	* Function : setGraph
+	* Usage    : finder.setGraph(&graph);
+	* ------------------------------------
+	* Points the finder at a (new) graph, the scratch space is sized for
+	* it on the next query.
+	*/
+	void setGraph(const CSRGraph * searchGraph);
+
+	/*
+	* Function : findPaths
+	* Usage    : int found = finder.findPaths(startId, endId, numPaths);
+	* ----------------------------------------------------------------
+	* Finds up to numPaths paths from start to end, cheapest first, none
+	* visiting a node twice, and returns how many there are. Fewer than
+	* numPaths are found when the graph doesn't have that many, none if
+	* end can't be reached. getPathLinks and getPathCost describe them.
+	*/
+	int findPaths(int start, int end, int numPaths);
+
+	/*
+	* Function : getPathLinks, getPathCost
+	* Usage    : finder.getPathLinks(i, linkIds);
+	* --------------------------------------------
+	* The ids of the links of the i-th path found by the last query, in
+	* order from the start, and the cost of that path.
+	*/
+	void getPathLinks(int index, std::vector<int> &linkIds);
+	double getPathCost(int index);
+
+	/*
+	* Function : getStats
+	* Usage    : searchStatsT stats = finder.getStats();
+	* ---------------------------------------------------
+	* What the last query did, the backward search and every spur search
+	* added up, all zero unless compiled with COLLECT_SEARCH_STATS (see
+	* searchstats.h).
+	*/
+	searchStatsT getStats();
+
+private:
+	struct acceptedPathT{
+		std::vector<int> links;
+		std::vector<int> nodes;            // links.size()+1 nodes, start first
+		std::vector<double> prefixCosts;   // cost of the first i links
+		int deviation;                     // first node not shared with the path it branched off
+	};
+
+	struct candidateT{
+		int parent;                        // accepted path the root is taken from
+		int rootLength;                    // links of the parent the root keeps
+		int firstSpurLink, numSpurLinks;   // range of spurLinks
+		double cost;
+		unsigned int hash;                 // of the whole link sequence
+	};
+
+	// Candidates not accepted yet, cheapest first
+	struct candidateOrderT{
+		double cost;
+		unsigned int hash;
+		int index;
+		bool operator<(const candidateOrderT &other) const;
+	};
+
+	const CSRGraph * graph;
+	int pathEnd;
+	PathFinder backwardTree;
+	double startDistance;                  // the estimate of nodes the backward search didn't settle
+	std::vector<acceptedPathT> accepted;
+	std::vector<candidateT> candidates;
+	std::set<candidateOrderT> openCandidates;
+	std::vector<int> spurLinks;
+
+	// Labels of the spur searches, indexed by node id
+	std::vector<double> distances;
+	std::vector<int> predecessorLinks;
+	std::vector<int> touched;
+	SearchFrontier frontier;
+	std::vector<int> nodeBlocked;          // number of the spur search that blocks the node
+	std::vector<int> linkBlocked;          // the same for links
+	int spurSearchCount;
+	searchStatsT stats;
+
+	void sizeScratch();
+	void acceptPath(int start, const std::vector<int> &links, int deviation);
+	void addSpurCandidates(int pathIndex);
+	bool searchSpur(int spur);
+	void addCandidate(int parent, int rootLength, int firstSpurLink);
+	void getCandidateLinks(const candidateT &candidate, std::vector<int> &linkIds);
+	double estimateToEnd(int node);
+	int otherEnd(int linkId, int node);
+	static unsigned int hashLinks(const std::vector<int> &linkIds);
+};
+
+KShortestPaths::KShortestPaths(const CSRGraph * searchGraph){
+	graph = searchGraph;
+	pathEnd = -1;
+	startDistance = 0;
+	spurSearchCount = 0;
+	stats = NO_SEARCH_STATS;
+}
+
+void KShortestPaths::setGraph(const CSRGraph * searchGraph){
+	graph = searchGraph;
+	distances.clear();
+}
+
+bool KShortestPaths::candidateOrderT::operator<(const candidateOrderT &other) const{
+	if(cost != other.cost) return cost < other.cost;
+	if(hash != other.hash) return hash < other.hash;
+	return index < other.index;
+}
+
+int KShortestPaths::findPaths(int start, int end, int numPaths){
+	COUNT_STAT(stats = NO_SEARCH_STATS);
+	sizeScratch();
+	accepted.clear();
+	candidates.clear();
+	openCandidates.clear();
+	spurLinks.clear();
+	pathEnd = end;
+	if(numPaths <= 0) return 0;
+
+	backwardTree.startSearch(end);
+	bool reachable = backwardTree.resumeSearch(start);
+	COUNT_STAT(addStats(stats, backwardTree.getStats()));
+	if(!reachable) return 0;
+	startDistance = backwardTree.getDistance(start);
+	std::vector<int> links;
+	backwardTree.getPathLinks(start, links);
+	std::reverse(links.begin(), links.end());
+	acceptPath(start, links, 0);
+
+	while((int)accepted.size() < numPaths){
+		addSpurCandidates(accepted.size() - 1);
+		if(openCandidates.empty()) break;
+		const candidateT &next = candidates[openCandidates.begin()->index];
+		openCandidates.erase(openCandidates.begin());
+		getCandidateLinks(next, links);
+		acceptPath(start, links, next.rootLength);
+	}
+	return accepted.size();
+}
+
+void KShortestPaths::getPathLinks(int index, std::vector<int> &linkIds){
+	linkIds = accepted[index].links;
+}
+
+double KShortestPaths::getPathCost(int index){
+	return accepted[index].prefixCosts.back();
+}
+
+searchStatsT KShortestPaths::getStats(){
+	return stats;
+}
+
+// Sizes the spur search labels for the graph, which may have gained links since the last query
+void KShortestPaths::sizeScratch(){
+	if(backwardTree.getGraph() != graph) backwardTree.setGraph(graph);
+	if((int)distances.size() != graph->numNodes()){
+		COUNT_STAT(stats.allocations++);
+		distances.assign(graph->numNodes(), INFINITE_DISTANCE);
+		predecessorLinks.assign(graph->numNodes(), NO_LINK);
+		nodeBlocked.assign(graph->numNodes(), 0);
+		touched.clear();
+		frontier.reserve(graph->numNodes());
+	}
+	if((int)linkBlocked.size() != graph->numLinks()) linkBlocked.resize(graph->numLinks(), 0);
+}
+
+// Lays the path out in full, the links given are in order from start
+void KShortestPaths::acceptPath(int start, const std::vector<int> &links, int deviation){
+	accepted.push_back(acceptedPathT());
+	acceptedPathT &path = accepted.back();
+	path.links = links;
+	path.deviation = deviation;
+	path.nodes.push_back(start);
+	path.prefixCosts.push_back(0);
+	for(int i = 0; i < (int)links.size(); i++){
+		path.nodes.push_back(otherEnd(links[i], path.nodes.back()));
+		path.prefixCosts.push_back(path.prefixCosts.back() + graph->getLinkCost(links[i]));
+	}
+}
+
+/*
+* Spurs off the given accepted path at every node from its deviation on.
+* The links blocked at spur node i are the (i+1)-th links of the accepted
+* paths whose first i links are the same as this path's.
+*/
+void KShortestPaths::addSpurCandidates(int pathIndex){
+	const acceptedPathT &path = accepted[pathIndex];
+	for(int i = path.deviation; i < (int)path.links.size(); i++){
+		spurSearchCount++;
+		for(int j = 0; j < i; j++)
+			nodeBlocked[path.nodes[j]] = spurSearchCount;
+		for(int other = 0; other < (int)accepted.size(); other++){
+			const acceptedPathT &otherPath = accepted[other];
+			if((int)otherPath.links.size() <= i) continue;
+			if(!std::equal(path.links.begin(), path.links.begin() + i, otherPath.links.begin())) continue;
+			linkBlocked[otherPath.links[i]] = spurSearchCount;
+		}
+		int firstSpurLink = spurLinks.size();
+		if(searchSpur(path.nodes[i])) addCandidate(pathIndex, i, firstSpurLink);
+	}
+}
+
+/*
+* A* from the spur node to the end on the graph less the blocked nodes
+* and links. Returns false if the end can't be reached, otherwise puts
+* the spur links at the back of spurLinks, in order from the spur node.
+*/
+bool KShortestPaths::searchSpur(int spur){
+	for(int i = 0; i < (int)touched.size(); i++){
+		distances[touched[i]] = INFINITE_DISTANCE;
+		predecessorLinks[touched[i]] = NO_LINK;
+	}
+	touched.clear();
+	frontier.clear();
+	frontier.useIntegerKeys(graph->hasIntegerCosts());
+	COUNT_STAT(frontier.clearStats());
+
+	distances[spur] = 0;
+	touched.push_back(spur);
+	frontier.enqueue(spur, estimateToEnd(spur));
+	bool found = false;
+	while(!frontier.isEmpty()){
+		int current = frontier.dequeueMin();
+		COUNT_STAT(stats.nodesSettled++);
+		if(current == pathEnd){
+			found = true;
+			break;
+		}
+		double currentDistance = distances[current];
+		int lastEdge = graph->endEdge(current);
+		COUNT_STAT(stats.edgesRelaxed += lastEdge - graph->firstEdge(current));
+		for(int edge = graph->firstEdge(current); edge < lastEdge; edge++){
+			int neighbor = graph->getTarget(edge);
+			int linkId = graph->getLinkId(edge);
+			if(nodeBlocked[neighbor] == spurSearchCount || linkBlocked[linkId] == spurSearchCount) continue;
+			double newDistance = currentDistance + graph->getCost(edge);
+			if(newDistance >= distances[neighbor]) continue;
+			if(distances[neighbor] == INFINITE_DISTANCE) touched.push_back(neighbor);
+			distances[neighbor] = newDistance;
+			predecessorLinks[neighbor] = linkId;
+			double key = newDistance + estimateToEnd(neighbor);
+			if(frontier.contains(neighbor)) frontier.decreaseKey(neighbor, key);
+			else frontier.enqueue(neighbor, key);
+		}
+	}
+	COUNT_STAT(addStats(stats, frontier.getStats()));
+	if(!found) return false;
+
+	int firstLink = spurLinks.size();
+	for(int node = pathEnd; node != spur; node = otherEnd(predecessorLinks[node], node))
+		spurLinks.push_back(predecessorLinks[node]);
+	std::reverse(spurLinks.begin() + firstLink, spurLinks.end());
+	return true;
+}
+
+/*
+* Makes a candidate of the root of the parent and the spur links from
+* firstSpurLink to the back of spurLinks, or drops those links if the
+* same path is a candidate already (two spur nodes can lead to it). The
+* cost is added up from the start as for accepted paths, so the same
+* path always comes to the same cost.
+*/
+void KShortestPaths::addCandidate(int parent, int rootLength, int firstSpurLink){
+	candidateT candidate = {parent, rootLength, firstSpurLink, (int)spurLinks.size() - firstSpurLink, 0, 0};
+	std::vector<int> links, otherLinks;
+	getCandidateLinks(candidate, links);
+	for(int i = 0; i < (int)links.size(); i++)
+		candidate.cost += graph->getLinkCost(links[i]);
+	candidate.hash = hashLinks(links);
+	double cost = candidate.cost;
+	candidateOrderT order = {cost, candidate.hash, -1};
+	std::set<candidateOrderT>::iterator it = openCandidates.lower_bound(order);
+	for(; it != openCandidates.end() && it->cost == cost && it->hash == candidate.hash; ++it){
+		getCandidateLinks(candidates[it->index], otherLinks);
+		if(otherLinks == links){
+			spurLinks.resize(firstSpurLink);
+			return;
+		}
+	}
+	order.index = candidates.size();
+	candidates.push_back(candidate);
+	openCandidates.insert(order);
+}
+
+void KShortestPaths::getCandidateLinks(const candidateT &candidate, std::vector<int> &linkIds){
+	const std::vector<int> &root = accepted[candidate.parent].links;
+	linkIds.assign(root.begin(), root.begin() + candidate.rootLength);
+	linkIds.insert(linkIds.end(), spurLinks.begin() + candidate.firstSpurLink,
+		spurLinks.begin() + candidate.firstSpurLink + candidate.numSpurLinks);
+}
+
+double KShortestPaths::estimateToEnd(int node){
+	return backwardTree.isSettled(node) ? backwardTree.getDistance(node) : startDistance;
+}
+
+int KShortestPaths::otherEnd(int linkId, int node){
+	int linkStart = graph->getLinkStart(linkId);
+	return (linkStart == node) ? graph->getLinkEnd(linkId) : linkStart;
+}
+
+// FNV-1a over the link ids
+unsigned int KShortestPaths::hashLinks(const std::vector<int> &linkIds){
+	unsigned int hash = 2166136261u;
+	for(int i = 0; i < (int)linkIds.size(); i++){
+		hash ^= (unsigned int)linkIds[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+#endif
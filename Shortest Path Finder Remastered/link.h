@@ -20,13 +20,15 @@ class Link{
 public :
 	/*
 	* Function : Constructor function for the Link Class
-	* Usage    : Link sampleLink(start, end)
+	* Usage    : Link sampleLink(start, end, cost, id)
 	* ---------------------------------------------------
 	* The constructor of the Link class takes in the pointers
 	* to two locations as parameters one which acts like the 
-	* begenning and one that acts as end.
+	* begenning and one that acts as end. The id is handed out 
+	* by the chart in the order the links are added (0, 1, 2 ...) 
+	* and is the id the link has in the chart's graph.
 	*/
-	Link(Position* startPos, Position* endPos, double linkCost);
+	Link(Position* startPos, Position* endPos, double linkCost, int linkId);
 
 	/*
 	* Function : Destructor function for the Link class
@@ -44,6 +46,21 @@ public :
 	*/
 	double getCost();
 
+	/*
+	* Function : setCost
+	* Usage    : sampleLink.setCost(newCost);
+	* ----------------------------------------
+	* Only the chart changes the cost of a link, see Chart::setLinkCost.
+	*/
+	void setCost(double linkCost);
+
+	/*
+	* Function : getId
+	* Usage    : int sampleLinkId = sampleLink.getId();
+	* -------------------------------------------------
+	*/
+	int getId();
+
 	/*
 	* Function : getOtherEnd
 	* Usage    : Position * samplePos = sampleLink.getOtherEnd(pointer to a position)
@@ -75,15 +92,14 @@ private:
 	Position* start;
 	Position * end;
 	double cost;
+	int id;
 };
 
-
-#endif
-
-Link::Link(Position* startPos, Position* endPos, double linkCost){
+Link::Link(Position* startPos, Position* endPos, double linkCost, int linkId){
 	start = startPos;
 	end = endPos;
 	cost = linkCost;
+	id = linkId;
 };
 
 Link::~Link(){};
@@ -92,6 +108,14 @@ double Link::getCost(){
 	return cost;
 }
 
+void Link::setCost(double linkCost){
+	cost = linkCost;
+}
+
+int Link::getId(){
+	return id;
+}
+
 Position * Link::getOtherEnd(Position * pos){
 	if(pos == start) return end;
 	else return start;
@@ -106,3 +130,4 @@ Position * Link::getEnd(){
 	return end;
 }
 
+#endif
@@ -1,6 +1,7 @@
 #include <iostream>
 #include "simpio.h"
 #include "chart.h"
+#include "extgraphrenderer.h"
 
 /* Function: GetMouseClick
  * Usage:  loc = GetMouseClick();
@@ -30,7 +31,8 @@ string GetPositionName(Chart &ch){
 
 int main(){
 	InitGraphics();
-	Chart myChart("USA.txt");
+	ExtGraphRenderer renderer;
+	Chart myChart("USA.txt", &renderer);
 
 	cout<<"Choose a starting position by clicking on the map"<<endl;
 	string startPosName = GetPositionName(myChart);
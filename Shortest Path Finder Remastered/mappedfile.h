@@ -0,0 +1,153 @@
+/*
+* File : mappedfile.h
+* --------------------
+* Defines the MappedFile class which maps a whole file read only into
+* memory, so its bytes can be used in place without reading them into
+* a buffer first. On Windows this goes through CreateFileMapping and
+* MapViewOfFile, elsewhere through mmap.
+*/
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include "genlib.h"
+
+class MappedFile{
+public:
+	MappedFile();
+
+	/*
+	* Function : Destructor function for the MappedFile class
+	* --------------------------------------------------------
+	* Unmaps the file if one is mapped.
+	*/
+	~MappedFile();
+
+	/*
+	* Function : open
+	* Usage    : if(file.open("USA.txt.bin")) ...
+	* ---------------------------------------------
+	* Maps the named file, returns false if it can't be opened or is empty.
+	*/
+	bool open(string fileName);
+
+	/*
+	* Function : close
+	* Usage    : file.close();
+	* -------------------------
+	*/
+	void close();
+
+	/*
+	* Function : getData, getSize
+	* Usage    : const char * bytes = file.getData();
+	* -----------------------------------------------
+	* The mapped bytes, valid until the file is closed.
+	*/
+	const char * getData();
+	long getSize();
+
+private:
+	const char * data;
+	long size;
+#ifdef _WIN32
+	HANDLE fileHandle;
+	HANDLE mappingHandle;
+#endif
+
+	// Mappings can't be shared between copies
+	MappedFile(const MappedFile &);
+	MappedFile & operator=(const MappedFile &);
+};
+
+MappedFile::MappedFile(){
+	data = NULL;
+	size = 0;
+#ifdef _WIN32
+	fileHandle = INVALID_HANDLE_VALUE;
+	mappingHandle = NULL;
+#endif
+}
+
+MappedFile::~MappedFile(){
+	close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(string fileName){
+	close();
+	fileHandle = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if(fileHandle == INVALID_HANDLE_VALUE) return false;
+	size = GetFileSize(fileHandle, NULL);
+	if(size <= 0){
+		close();
+		return false;
+	}
+	mappingHandle = CreateFileMapping(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+	if(mappingHandle != NULL) data = (const char *)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+	if(data == NULL){
+		close();
+		return false;
+	}
+	return true;
+}
+
+void MappedFile::close(){
+	if(data != NULL) UnmapViewOfFile(data);
+	if(mappingHandle != NULL) CloseHandle(mappingHandle);
+	if(fileHandle != INVALID_HANDLE_VALUE) CloseHandle(fileHandle);
+	data = NULL;
+	size = 0;
+	mappingHandle = NULL;
+	fileHandle = INVALID_HANDLE_VALUE;
+}
+
+#else
+
+bool MappedFile::open(string fileName){
+	close();
+	int fd = ::open(fileName.c_str(), O_RDONLY);
+	if(fd == -1) return false;
+	struct stat info;
+	if(fstat(fd, &info) != 0 || info.st_size <= 0){
+		::close(fd);
+		return false;
+	}
+	void * mapping = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if(mapping == MAP_FAILED) return false;
+	data = (const char *)mapping;
+	size = info.st_size;
+	return true;
+}
+
+void MappedFile::close(){
+	if(data != NULL) munmap((void *)data, size);
+	data = NULL;
+	size = 0;
+}
+
+#endif
+
+const char * MappedFile::getData(){
+	return data;
+}
+
+long MappedFile::getSize(){
+	return size;
+}
+
+#endif
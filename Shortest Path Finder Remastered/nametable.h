@@ -0,0 +1,187 @@
+/*
+* File : nametable.h
+* -------------------
+* Defines the NameTable class which interns the names of the positions
+* of a chart: every name is stored once, in one block of characters,
+* and is known by its id, the order in which it was added (0, 1, 2 ...).
+* Everything past loading works with ids, a name is only looked up when
+* it comes in through the Chart's interface or is handed back out.
+*
+* Implementation notes
+* ---------------------
+* Name i starts at chars[offsets[i]] and is ended by a '\0', which is
+* also how the compiled chart file stores them (see chartbinary.h). The
+* length of every name is kept as well, since a name read from a text
+* file may hold a '\0' of its own. Ids are found through an open
+* addressing hash table over that block with FNV-1a hashes and linear
+* probing, kept at most half full, so looking a name up creates no
+* string and compares characters in place.
+*/
+
+#ifndef NAME_TABLE_H
+#define NAME_TABLE_H
+
+#include <cstring>
+#include <vector>
+#include "genlib.h"
+
+class NameTable{
+public:
+	/*
+	* Function : Constructor function for the NameTable class
+	* Usage    : NameTable names;
+	* ----------------------------
+	* Creates an empty table.
+	*/
+	NameTable();
+
+	/*
+	* Function : add
+	* Usage    : int id = names.add(name, length);
+	* ---------------------------------------------
+	* Adds the name made of the given characters and returns its id. The
+	* caller makes sure it isn't in the table already (see find).
+	*/
+	int add(const char * name, int length);
+
+	/*
+	* Function : assign
+	* Usage    : names.assign(chars, offsets);
+	* -----------------------------------------
+	* Takes over names laid out as described in the implementation notes,
+	* leaving chars and offsets empty, and indexes them.
+	*/
+	void assign(std::vector<char> &chars, std::vector<int> &offsets);
+
+	/*
+	* Function : find
+	* Usage    : int id = names.find(name);
+	* --------------------------------------
+	* Returns the id of the name, or -1 if it isn't in the table.
+	*/
+	int find(const char * name, int length) const;
+	int find(const string &name) const;
+
+	/*
+	* Function : getName
+	* Usage    : const char * name = names.getName(id);
+	* --------------------------------------------------
+	* The pointer stays valid until the table is added to, assigned or
+	* destroyed (swapping tables takes the names along).
+	*/
+	const char * getName(int id) const;
+
+	int size() const;
+
+	// The names laid out as described in the implementation notes
+	const std::vector<char> & getChars() const;
+	const std::vector<int> & getOffsets() const;
+
+	void swap(NameTable &other);
+
+private:
+	std::vector<char> chars;
+	std::vector<int> offsets;
+	std::vector<int> lengths;
+	std::vector<int> slots;      // open addressing table of ids, -1 if free
+
+	void insert(int id, unsigned int hash);
+	void rebuildSlots(int minSlots);
+	static unsigned int hashName(const char * name, int length);
+};
+
+NameTable::NameTable(){
+	slots.assign(16, -1);
+}
+
+int NameTable::add(const char * name, int length){
+	int id = offsets.size();
+	if(2 * (id + 1) > (int)slots.size()) rebuildSlots(slots.size() * 2);
+	offsets.push_back(chars.size());
+	lengths.push_back(length);
+	chars.insert(chars.end(), name, name + length);
+	chars.push_back('\0');
+	insert(id, hashName(name, length));
+	return id;
+}
+
+void NameTable::assign(std::vector<char> &nameChars, std::vector<int> &nameOffsets){
+	chars.clear();
+	offsets.clear();
+	chars.swap(nameChars);
+	offsets.swap(nameOffsets);
+	// Names end where the next one starts, unless the block is laid out otherwise
+	lengths.resize(offsets.size());
+	for(int id = 0; id < (int)offsets.size(); id++){
+		int next = (id + 1 < (int)offsets.size()) ? offsets[id + 1] : chars.size();
+		if(next > offsets[id] && chars[next - 1] == '\0') lengths[id] = next - offsets[id] - 1;
+		else lengths[id] = strlen(getName(id));
+	}
+	int minSlots = 16;
+	while(minSlots < 2 * (int)offsets.size()) minSlots *= 2;
+	rebuildSlots(minSlots);
+}
+
+int NameTable::find(const char * name, int length) const{
+	unsigned int mask = slots.size() - 1;
+	unsigned int slot = hashName(name, length) & mask;
+	while(slots[slot] != -1){
+		int id = slots[slot];
+		if(lengths[id] == length && memcmp(getName(id), name, length) == 0) return id;
+		slot = (slot + 1) & mask;
+	}
+	return -1;
+}
+
+int NameTable::find(const string &name) const{
+	return find(name.data(), name.size());
+}
+
+const char * NameTable::getName(int id) const{
+	return &chars[offsets[id]];
+}
+
+int NameTable::size() const{
+	return offsets.size();
+}
+
+const std::vector<char> & NameTable::getChars() const{
+	return chars;
+}
+
+const std::vector<int> & NameTable::getOffsets() const{
+	return offsets;
+}
+
+void NameTable::swap(NameTable &other){
+	chars.swap(other.chars);
+	offsets.swap(other.offsets);
+	lengths.swap(other.lengths);
+	slots.swap(other.slots);
+}
+
+void NameTable::insert(int id, unsigned int hash){
+	unsigned int mask = slots.size() - 1;
+	unsigned int slot = hash & mask;
+	while(slots[slot] != -1) slot = (slot + 1) & mask;
+	slots[slot] = id;
+}
+
+// Sizes the hash table to numSlots (a power of two) and puts every name back in
+void NameTable::rebuildSlots(int numSlots){
+	slots.assign(numSlots, -1);
+	for(int id = 0; id < (int)offsets.size(); id++)
+		insert(id, hashName(getName(id), lengths[id]));
+}
+
+// FNV-1a
+unsigned int NameTable::hashName(const char * name, int length){
+	unsigned int hash = 2166136261u;
+	for(int i = 0; i < length; i++){
+		hash ^= (unsigned char)name[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+#endif
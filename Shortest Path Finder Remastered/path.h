@@ -47,6 +47,11 @@ public :
 
 	/*
 	* Function : getTotalPathCost
+	* Usage    : double cost = samplePath.getTotalPathCost();
+	* -------------------------------------------------------
+	* Sums the costs the links have now, so the cost of a path held
+	* on to follows Chart::setLinkCost. The links themselves stay
+	* those of the path when it was found, a removed link included.
 	*/
 	double getTotalPathCost();
 
@@ -87,9 +92,10 @@ private:
 	Position * end;
 };
 
-#endif
-
-Path::Path(){};
+Path::Path(){
+	start = NULL;
+	end = NULL;
+};
 
 Path::Path(Position * startingPos){
 	start = startingPos;
@@ -103,11 +109,10 @@ void Path::addLinkToPath(Link* linkToAdd){
 }
 
 double Path::getTotalPathCost(){
-	double totalPathCost = 0;
-	for(int i = 0 ;i < links.size(); i++){
-		totalPathCost += links[i]->getCost();
-	}
-	return totalPathCost;
+	double totalCost = 0;
+	for(int i = 0; i < links.size(); i++)
+		totalCost += links[i]->getCost();
+	return totalCost;
 }
 
 void Path::popLinkFromPath(){
@@ -131,4 +136,6 @@ int Path::lengthInLinks(){
 
 Link* Path::getAt(int index){
 	return links[index];
-}
\ No newline at end of file
+}
+
+#endif
@@ -0,0 +1,845 @@
+/*
+* File : pathfinder.h
+* --------------------
+* Defines the PathFinder class which runs shortest path searches on a
+* CSRGraph. A PathFinder owns all the scratch space a search needs
+* (tentative distances, predecessor links, the frontier heap, one set
+* of each for searching forwards from the start and one for searching
+* backwards from the end), it is set apart once for the whole graph and
+* reused by every search, and only the entries a search actually touched
+* are reset before the next one.
+* On a graph whose costs are all whole numbers every search but A*
+* keeps its frontier in a RadixHeap rather than a comparison heap (see
+* searchfrontier.h).
+* A search paused by resumeSearch can be repaired when a link of the
+* graph changes (see repairSearch) instead of being run again.
+* Searches work purely on node and link ids, turning them back into
+* Positions and Links is left to the Chart.
+*/
+
+#ifndef PATH_FINDER_H
+#define PATH_FINDER_H
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+#include "csrgraph.h"
+#include "position.h"
+#include "searchfrontier.h"
+#include "searchstats.h"
+#include "stopwatch.h"
+
+const double INFINITE_DISTANCE = std::numeric_limits<double>::infinity();
+const int NO_LINK = -1;
+
+/*
+* Budgets for findShortestPathWithin, -1 leaves a budget out
+* maxCost    : paths costing more than this are not looked at
+* maxHops    : the search doesn't go on past nodes this many links
+*              from the start (along the cheapest way to them)
+* maxSettled : the search gives up after settling this many nodes
+*/
+struct searchLimitsT{
+	double maxCost;
+	int maxHops;
+	int maxSettled;
+};
+
+const searchLimitsT NO_SEARCH_LIMITS = {-1, -1, -1};
+
+/*
+* How a search ended
+* PATH_FOUND           : the end was reached within every budget
+* UNREACHABLE          : there is no path to the end at all
+* COST_LIMIT_REACHED   : the end wasn't reached for paths within maxCost
+* HOP_LIMIT_REACHED    : the end wasn't reached within maxHops links
+* SETTLE_LIMIT_REACHED : the search ran out of maxSettled first
+*/
+enum searchStatusT {PATH_FOUND, UNREACHABLE, COST_LIMIT_REACHED, HOP_LIMIT_REACHED, SETTLE_LIMIT_REACHED};
+
+class PathFinder{
+public:
+	/*
+	* Function : Constructor function for the PathFinder class
+	* Usage    : PathFinder finder(&graph);
+	* ------------------------------------------------------
+	* The graph is not copied and must outlive the PathFinder.
+	*/
+	PathFinder(const CSRGraph * searchGraph = NULL);
+
+	/*
+	* Function : setGraph
+	* Usage    : finder.setGraph(&graph);
+	* ------------------------------------
+	* Points the finder at a (new) graph and sizes the scratch space for it.
+	*/
+	void setGraph(const CSRGraph * searchGraph);
+	const CSRGraph * getGraph();
+
+	/*
+	* Function : findShortestPath
+	* Usage    : if(finder.findShortestPath(startId, endId)) ...
+	* ----------------------------------------------------------
+	* Runs Dijkstra from start until end is settled. Returns false if
+	* end can't be reached. Afterwards getDistance and getPathLinks
+	* describe the result.
+	*/
+	bool findShortestPath(int start, int end);
+
+	/*
+	* Function : setHeuristic
+	* Usage    : finder.setHeuristic(&coords, scale);
+	* ------------------------------------------------
+	* Gives A* the coordinates of the nodes (indexed by node id, not
+	* copied) and the factor that turns straight line distance into a
+	* lower bound on cost, see calibrateHeuristicScale.
+	*/
+	void setHeuristic(const std::vector<coordT> * nodeCoords, double scale);
+
+	/*
+	* Function : findShortestPathAStar
+	* Usage    : if(finder.findShortestPathAStar(startId, endId)) ...
+	* ---------------------------------------------------------------
+	* Same as findShortestPath but nodes are taken in order of their
+	* distance from the start plus the scaled straight line distance 
+	* to the end, so the search heads towards the end rather than 
+	* spreading out in every direction. Needs setHeuristic.
+	*/
+	bool findShortestPathAStar(int start, int end);
+
+	/*
+	* Function : findShortestPathBidirectional
+	* Usage    : if(finder.findShortestPathBidirectional(startId, endId)) ...
+	* -----------------------------------------------------------------------
+	* Same as findShortestPath but searches forwards from the start and 
+	* backwards from the end at the same time (links work both ways) 
+	* until the two searches meet, which roughly halves the part of the 
+	* graph looked at on long queries.
+	*/
+	bool findShortestPathBidirectional(int start, int end);
+
+	/*
+	* Function : findDistancesFrom
+	* Usage    : finder.findDistancesFrom(startId, targetIds, costs);
+	* ---------------------------------------------------------------
+	* Runs Dijkstra from start until every one of the targets is settled
+	* and fills costs with the distance to each target, in the same order,
+	* INFINITE_DISTANCE for those that can't be reached. getDistance and
+	* getPathLinks work afterwards as after findShortestPath.
+	*/
+	void findDistancesFrom(int start, const std::vector<int> &targets, std::vector<double> &costs);
+
+	/*
+	* Function : startSearch, resumeSearch
+	* Usage    : finder.startSearch(startId);
+	*            if(finder.resumeSearch(endId)) ...
+	* -----------------------------------------------
+	* startSearch sets up a Dijkstra search from start without settling
+	* anything, resumeSearch carries it on until end is settled and then
+	* pauses it. Returns false if end can't be reached. A later
+	* resumeSearch for another end only settles the nodes not settled
+	* yet, and returns at once if that end was settled before. Any other
+	* search on the same PathFinder ends the paused one.
+	*/
+	void startSearch(int start);
+	bool resumeSearch(int end);
+
+	/*
+	* Function : repairSearch
+	* Usage    : finder.repairSearch(linkId, oldCost, newCost);
+	* ----------------------------------------------------------
+	* Brings a search set up by startSearch back in line with the graph
+	* after one link changed cost, INFINITE_DISTANCE standing for a link
+	* that isn't there (one just added, or removed). The graph must have
+	* the change already. Only the nodes the change reaches are looked at
+	* again, afterwards the search is where it would be had it run on the
+	* changed graph from the start and resumeSearch carries on from there.
+	*/
+	void repairSearch(int linkId, double oldCost, double newCost);
+
+	/*
+	* Function : findShortestPathWithin
+	* Usage    : searchStatusT status = finder.findShortestPathWithin(startId, endId, limits);
+	* ------------------------------------------------------------------------------------
+	* Same as findShortestPath but cut off as soon as one of the budgets
+	* in limits runs out, which keeps the time a query can take bounded.
+	* The status tells whether the end was reached and, if not, why.
+	* getDistance and getPathLinks describe the path if it was.
+	*/
+	searchStatusT findShortestPathWithin(int start, int end, const searchLimitsT &limits);
+
+	/*
+	* Function : findReachableWithin
+	* Usage    : finder.findReachableWithin(startId, maxCost, nodeIds, &linkIds);
+	* -------------------------------------------------------------------------
+	* Runs Dijkstra from start over the nodes at most maxCost away and
+	* fills nodes with them, nearest first, the start included. If links
+	* is given it gets the links that can be crossed from end to end
+	* within maxCost, each once. getDistance and getPathLinks work for the
+	* nodes found afterwards. Takes time in proportion to the part of the
+	* graph within reach, not to the whole graph.
+	*/
+	void findReachableWithin(int start, double maxCost, std::vector<int> &nodes, std::vector<int> * links = NULL);
+
+	/*
+	* Function : getNumSettled
+	* Usage    : int work = finder.getNumSettled();
+	* ----------------------------------------------
+	* The number of nodes the last search settled, a measure of the work
+	* it did.
+	*/
+	int getNumSettled();
+
+	/*
+	* Function : getStats
+	* Usage    : searchStatsT stats = finder.getStats();
+	* ---------------------------------------------------
+	* What the last search (or the last resumeSearch) did, all zero
+	* unless compiled with COLLECT_SEARCH_STATS (see searchstats.h).
+	* Search and path times are left for the caller to fill in.
+	*/
+	searchStatsT getStats();
+
+	/*
+	* Function : getSource
+	* Usage    : int startId = finder.getSource();
+	* ---------------------------------------------
+	* The start of the last search, -1 before the first one.
+	*/
+	int getSource();
+
+	/*
+	* Function : getDistance
+	* Usage    : double cost = finder.getDistance(nodeId);
+	* ---------------------------------------------------
+	* Cost of the cheapest way found to the node by the last search,
+	* INFINITE_DISTANCE if the search never reached it.
+	*/
+	double getDistance(int node);
+
+	/*
+	* Function : isSettled
+	* Usage    : if(finder.isSettled(nodeId)) ...
+	* ---------------------------------------------
+	* True if the last search settled the node, getDistance is then the
+	* cost of the cheapest way to it and not just the best found so far.
+	*/
+	bool isSettled(int node);
+
+	/*
+	* Function : getPathLinks
+	* Usage    : finder.getPathLinks(endId, linkIds);
+	* ------------------------------------------------
+	* Fills linkIds with the ids of the links leading from the start of
+	* the last search to the given settled node, in order from the start.
+	*/
+	void getPathLinks(int end, std::vector<int> &linkIds);
+
+private:
+	/*
+	* The labels of one direction of search, indexed by node id
+	*/
+	struct searchLabelsT{
+		std::vector<double> distances;
+		std::vector<int> predecessorLinks;
+		std::vector<bool> settled;
+		std::vector<int> touched;    // nodes whose labels the last search changed
+		SearchFrontier frontier;
+		int numSettled;
+	};
+
+	const CSRGraph * graph;
+	int source;
+	searchLabelsT forward;           // labels of the search from the start, what getDistance reports
+	searchLabelsT backward;          // labels of the search from the end, sized by the first bidirectional search
+	std::vector<bool> isTarget;      // targets of findDistancesFrom not settled yet
+	std::vector<int> hopCounts;      // links from the start, findShortestPathWithin only
+	std::vector<int> dropped;        // nodes whose labels repairSearch took away
+	const std::vector<coordT> * coords;
+	double heuristicScale;
+	searchStatsT stats;
+
+	void beginSearch(int start);
+	void clearStats();
+	bool search(int start, int end, bool useHeuristic);
+	void scanBidirectional(bool fromStart, double &bestCost, int &meetForward, int &meetLink, int &meetBackward);
+	void spliceBackwardPath(int meetForward, int meetLink, int meetBackward);
+	int otherEnd(int linkId, int node);
+	double estimateToEnd(int node, coordT endCoords);
+	void sizeLabels(searchLabelsT &labels, int numNodes);
+	void resetLabels(searchLabelsT &labels);
+	void label(searchLabelsT &labels, int node, double distance, int linkId);
+	int settleNext();
+	void settleRepaired();
+	void reopen(int node, double distance, int linkId);
+	void dropSubtree(int root);
+	void dropLabels(int node);
+
+	// Predecessor link of a node repairSearch took the labels of, it is on the touched list already
+	static const int DROPPED_LINK = -2;
+};
+
+PathFinder::PathFinder(const CSRGraph * searchGraph){
+	graph = NULL;
+	source = -1;
+	coords = NULL;
+	heuristicScale = 0;
+	forward.numSettled = backward.numSettled = 0;
+	stats = NO_SEARCH_STATS;
+	if(searchGraph != NULL) setGraph(searchGraph);
+}
+
+void PathFinder::setGraph(const CSRGraph * searchGraph){
+	graph = searchGraph;
+	sizeLabels(forward, graph->numNodes());
+	backward = searchLabelsT();
+	isTarget.assign(graph->numNodes(), false);
+	source = -1;
+}
+
+const CSRGraph * PathFinder::getGraph(){
+	return graph;
+}
+
+bool PathFinder::findShortestPath(int start, int end){
+	return search(start, end, false);
+}
+
+void PathFinder::setHeuristic(const std::vector<coordT> * nodeCoords, double scale){
+	coords = nodeCoords;
+	heuristicScale = scale;
+}
+
+bool PathFinder::findShortestPathAStar(int start, int end){
+	return search(start, end, coords != NULL && heuristicScale > 0);
+}
+
+/*
+* Implementation notes : search
+* ------------------------------
+* Label setting Dijkstra, every node carries a tentative distance
+* and the link it was reached through. A node is in the frontier at
+* most once, finding a cheaper way to it lowers its key in place.
+* For A* the key of a node is its tentative distance plus the estimate
+* of what is left to the end. The estimate never overshoots and obeys
+* the triangle inequality along every link, so a node taken off the
+* frontier is still final and the same loop serves both.
+*/
+bool PathFinder::search(int start, int end, bool useHeuristic){
+	beginSearch(start);
+	coordT endCoords = {0, 0};
+	if(useHeuristic){
+		// The estimates make the keys fractional, whatever the costs
+		forward.frontier.useIntegerKeys(false);
+		endCoords = (*coords)[end];
+	}
+	label(forward, start, 0, NO_LINK);
+	forward.frontier.enqueue(start, useHeuristic ? estimateToEnd(start, endCoords) : 0);
+
+	while(!forward.frontier.isEmpty()){
+		int current = forward.frontier.dequeueMin();
+		forward.settled[current] = true;
+		forward.numSettled++;
+		COUNT_STAT(stats.nodesSettled++);
+		if(current == end) return true;
+
+		double currentDistance = forward.distances[current];
+		int lastEdge = graph->endEdge(current);
+		COUNT_STAT(stats.edgesRelaxed += lastEdge - graph->firstEdge(current));
+		for(int edge = graph->firstEdge(current); edge < lastEdge; edge++){
+			int neighbor = graph->getTarget(edge);
+			double newDistance = currentDistance + graph->getCost(edge);
+			if(!forward.settled[neighbor] && newDistance < forward.distances[neighbor]){
+				double key = newDistance;
+				if(useHeuristic) key += estimateToEnd(neighbor, endCoords);
+				if(forward.frontier.contains(neighbor)) forward.frontier.decreaseKey(neighbor, key);
+				else forward.frontier.enqueue(neighbor, key);
+				label(forward, neighbor, newDistance, graph->getLinkId(edge));
+			}
+		}
+	}
+	return false;
+}
+
+/*
+* Implementation notes : findShortestPathBidirectional
+* -----------------------------------------------------
+* Each round settles one node on whichever side has the smaller frontier.
+* Whenever a side looks along a link at a node the other side has a
+* label for, the two half paths joined by that link make a candidate and
+* the cheapest candidate so far is kept (bestCost). Once the smallest keys
+* of the two frontiers add up to bestCost or more no unseen path can be
+* cheaper, so the search stops. If one frontier runs dry its side has
+* settled everything it can reach and bestCost is final as well.
+* The backward half of the best path is then copied into the forward
+* labels so getDistance and getPathLinks work as after any other search.
+*/
+bool PathFinder::findShortestPathBidirectional(int start, int end){
+	beginSearch(start);
+	if((int)backward.distances.size() != graph->numNodes()){
+		COUNT_STAT(stats.allocations++);
+		sizeLabels(backward, graph->numNodes());
+	}
+	label(forward, start, 0, NO_LINK);
+	if(start == end) return true;
+	label(backward, end, 0, NO_LINK);
+	forward.frontier.enqueue(start, 0);
+	backward.frontier.enqueue(end, 0);
+
+	double bestCost = INFINITE_DISTANCE;
+	int meetForward = -1, meetLink = NO_LINK, meetBackward = -1;
+	while(!forward.frontier.isEmpty() && !backward.frontier.isEmpty()){
+		if(forward.frontier.peekMinKey() + backward.frontier.peekMinKey() >= bestCost) break;
+		bool fromStart = forward.frontier.size() <= backward.frontier.size();
+		scanBidirectional(fromStart, bestCost, meetForward, meetLink, meetBackward);
+	}
+	if(meetLink == NO_LINK) return false;
+	spliceBackwardPath(meetForward, meetLink, meetBackward);
+	return true;
+}
+
+void PathFinder::findDistancesFrom(int start, const std::vector<int> &targets, std::vector<double> &costs){
+	beginSearch(start);
+	int numLeft = 0;
+	for(int i = 0; i < (int)targets.size(); i++){
+		if(isTarget[targets[i]]) continue;
+		isTarget[targets[i]] = true;
+		numLeft++;
+	}
+	label(forward, start, 0, NO_LINK);
+	forward.frontier.enqueue(start, 0);
+
+	while(numLeft > 0 && !forward.frontier.isEmpty()){
+		int current = settleNext();
+		if(isTarget[current]){
+			isTarget[current] = false;
+			numLeft--;
+		}
+	}
+
+	costs.resize(targets.size());
+	for(int i = 0; i < (int)targets.size(); i++){
+		isTarget[targets[i]] = false;
+		costs[i] = forward.settled[targets[i]] ? forward.distances[targets[i]] : INFINITE_DISTANCE;
+	}
+}
+
+void PathFinder::startSearch(int start){
+	beginSearch(start);
+	label(forward, start, 0, NO_LINK);
+	forward.frontier.enqueue(start, 0);
+}
+
+bool PathFinder::resumeSearch(int end){
+	COUNT_STAT(clearStats());
+	while(!forward.settled[end]){
+		if(forward.frontier.isEmpty()) return false;
+		settleNext();
+	}
+	return true;
+}
+
+/*
+* Implementation notes : repairSearch
+* ------------------------------------
+* A paused search has settled every node nearer than the smallest key
+* of its frontier (the radius) and nothing further. A link getting
+* cheaper can only bring nodes nearer: if it gives one of its ends a
+* better label from its settled other end, that end is labelled again
+* and goes back into the frontier, settled or not. A link getting
+* dearer, or going, only matters if it is the predecessor link of one
+* of its ends, and then that end and everything labelled through it
+* (its subtree) lose their labels and are put back into the frontier
+* with the best label their settled neighbors outside the subtree give
+* them, if any. Either way the nodes put back may have keys below the
+* radius, so the frontier moves to the comparison heap and the search
+* settles nodes again until its smallest key is back at the radius,
+* this time taking a settled node back into the frontier whenever a
+* cheaper way to it turns up, which carries a shortcut on to every
+* node settled behind it.
+*/
+void PathFinder::repairSearch(int linkId, double oldCost, double newCost){
+	COUNT_STAT(clearStats());
+	if(!graph->hasIntegerCosts()) forward.frontier.allowAnyKeys();
+	double radius = forward.frontier.isEmpty() ? INFINITE_DISTANCE : forward.frontier.peekMinKey();
+	int linkEnds[2] = {graph->getLinkStart(linkId), graph->getLinkEnd(linkId)};
+	if(newCost < oldCost){
+		for(int i = 0; i < 2; i++){
+			int node = linkEnds[i], from = linkEnds[1 - i];
+			double newDistance = forward.distances[from] + newCost;
+			if(forward.settled[from] && newDistance < forward.distances[node]) reopen(node, newDistance, linkId);
+		}
+	}else if(newCost > oldCost){
+		for(int i = 0; i < 2; i++)
+			if(forward.predecessorLinks[linkEnds[i]] == linkId) dropSubtree(linkEnds[i]);
+	}
+	while(!forward.frontier.isEmpty() && forward.frontier.peekMinKey() < radius)
+		settleRepaired();
+}
+
+/*
+* Implementation notes : findShortestPathWithin
+* ----------------------------------------------
+* The plain Dijkstra loop with three extra checks: links that would lead
+* past maxCost are not followed, nodes maxHops links out are settled but
+* not looked beyond, and the loop stops once maxSettled nodes are done.
+* If the frontier runs dry without reaching the end, the status says
+* whether a budget cut part of the graph off or the end really can't be
+* reached.
+*/
+searchStatusT PathFinder::findShortestPathWithin(int start, int end, const searchLimitsT &limits){
+	beginSearch(start);
+	if((int)hopCounts.size() != graph->numNodes()){
+		COUNT_STAT(stats.allocations++);
+		hopCounts.resize(graph->numNodes());
+	}
+	label(forward, start, 0, NO_LINK);
+	hopCounts[start] = 0;
+	forward.frontier.enqueue(start, 0);
+
+	bool costCut = false, hopCut = false;
+	while(!forward.frontier.isEmpty()){
+		if(limits.maxSettled >= 0 && forward.numSettled >= limits.maxSettled) return SETTLE_LIMIT_REACHED;
+		int current = forward.frontier.dequeueMin();
+		forward.settled[current] = true;
+		forward.numSettled++;
+		COUNT_STAT(stats.nodesSettled++);
+		if(current == end) return PATH_FOUND;
+		if(limits.maxHops >= 0 && hopCounts[current] >= limits.maxHops){
+			hopCut = true;
+			continue;
+		}
+
+		double currentDistance = forward.distances[current];
+		int lastEdge = graph->endEdge(current);
+		COUNT_STAT(stats.edgesRelaxed += lastEdge - graph->firstEdge(current));
+		for(int edge = graph->firstEdge(current); edge < lastEdge; edge++){
+			int neighbor = graph->getTarget(edge);
+			double newDistance = currentDistance + graph->getCost(edge);
+			if(forward.settled[neighbor] || newDistance >= forward.distances[neighbor]) continue;
+			if(limits.maxCost >= 0 && newDistance > limits.maxCost){
+				costCut = true;
+				continue;
+			}
+			if(forward.frontier.contains(neighbor)) forward.frontier.decreaseKey(neighbor, newDistance);
+			else forward.frontier.enqueue(neighbor, newDistance);
+			label(forward, neighbor, newDistance, graph->getLinkId(edge));
+			hopCounts[neighbor] = hopCounts[current] + 1;
+		}
+	}
+	if(costCut) return COST_LIMIT_REACHED;
+	if(hopCut) return HOP_LIMIT_REACHED;
+	return UNREACHABLE;
+}
+
+/*
+* Implementation notes : findReachableWithin
+* -------------------------------------------
+* Dijkstra that never queues a node beyond maxCost, so the frontier and
+* the labels stay within reach. A link is listed by whichever of its
+* ends is settled first, when the cheaper way across it is known: the
+* other end is then either not settled yet or settled without being
+* able to cross the link within the budget. Links from a node to itself
+* go nowhere and are left out.
+*/
+void PathFinder::findReachableWithin(int start, double maxCost, std::vector<int> &nodes, std::vector<int> * links){
+	beginSearch(start);
+	nodes.clear();
+	if(links != NULL) links->clear();
+	if(maxCost < 0) return;
+	label(forward, start, 0, NO_LINK);
+	forward.frontier.enqueue(start, 0);
+
+	while(!forward.frontier.isEmpty()){
+		int current = forward.frontier.dequeueMin();
+		forward.settled[current] = true;
+		forward.numSettled++;
+		COUNT_STAT(stats.nodesSettled++);
+		nodes.push_back(current);
+
+		double currentDistance = forward.distances[current];
+		int lastEdge = graph->endEdge(current);
+		COUNT_STAT(stats.edgesRelaxed += lastEdge - graph->firstEdge(current));
+		for(int edge = graph->firstEdge(current); edge < lastEdge; edge++){
+			int neighbor = graph->getTarget(edge);
+			double newDistance = currentDistance + graph->getCost(edge);
+			if(newDistance > maxCost) continue;
+			if(links != NULL && (!forward.settled[neighbor] || forward.distances[neighbor] + graph->getCost(edge) > maxCost))
+				links->push_back(graph->getLinkId(edge));
+			if(forward.settled[neighbor] || newDistance >= forward.distances[neighbor]) continue;
+			if(forward.frontier.contains(neighbor)) forward.frontier.decreaseKey(neighbor, newDistance);
+			else forward.frontier.enqueue(neighbor, newDistance);
+			label(forward, neighbor, newDistance, graph->getLinkId(edge));
+		}
+	}
+}
+
+int PathFinder::getNumSettled(){
+	return forward.numSettled + backward.numSettled;
+}
+
+searchStatsT PathFinder::getStats(){
+	searchStatsT result = stats;
+	addStats(result, forward.frontier.getStats());
+	addStats(result, backward.frontier.getStats());
+	return result;
+}
+
+void PathFinder::clearStats(){
+	stats = NO_SEARCH_STATS;
+	forward.frontier.clearStats();
+	backward.frontier.clearStats();
+}
+
+// Clears what the last search left behind and makes start the source of the next
+void PathFinder::beginSearch(int start){
+	COUNT_STAT(Stopwatch watch);
+	COUNT_STAT(clearStats());
+	resetLabels(forward);
+	resetLabels(backward);
+	forward.frontier.useIntegerKeys(graph->hasIntegerCosts());
+	backward.frontier.useIntegerKeys(graph->hasIntegerCosts());
+	source = start;
+	COUNT_STAT(stats.setupSeconds = watch.getSeconds());
+}
+
+int PathFinder::getSource(){
+	return source;
+}
+
+/*
+* Takes the nearest node off the forward frontier, settles it and looks
+* along its links. Unlike search it always finishes with the links of
+* the node it settles, so a search can be left and picked up between
+* any two calls.
+*/
+int PathFinder::settleNext(){
+	int current = forward.frontier.dequeueMin();
+	forward.settled[current] = true;
+	forward.numSettled++;
+	COUNT_STAT(stats.nodesSettled++);
+	double currentDistance = forward.distances[current];
+	int lastEdge = graph->endEdge(current);
+	COUNT_STAT(stats.edgesRelaxed += lastEdge - graph->firstEdge(current));
+	for(int edge = graph->firstEdge(current); edge < lastEdge; edge++){
+		int neighbor = graph->getTarget(edge);
+		double newDistance = currentDistance + graph->getCost(edge);
+		if(!forward.settled[neighbor] && newDistance < forward.distances[neighbor]){
+			if(forward.frontier.contains(neighbor)) forward.frontier.decreaseKey(neighbor, newDistance);
+			else forward.frontier.enqueue(neighbor, newDistance);
+			label(forward, neighbor, newDistance, graph->getLinkId(edge));
+		}
+	}
+	return current;
+}
+
+// settleNext for repairSearch, a cheaper way to a settled neighbor takes it back into the frontier
+void PathFinder::settleRepaired(){
+	int current = forward.frontier.dequeueMin();
+	forward.settled[current] = true;
+	forward.numSettled++;
+	COUNT_STAT(stats.nodesSettled++);
+	double currentDistance = forward.distances[current];
+	int lastEdge = graph->endEdge(current);
+	COUNT_STAT(stats.edgesRelaxed += lastEdge - graph->firstEdge(current));
+	for(int edge = graph->firstEdge(current); edge < lastEdge; edge++){
+		double newDistance = currentDistance + graph->getCost(edge);
+		if(newDistance < forward.distances[graph->getTarget(edge)]) reopen(graph->getTarget(edge), newDistance, graph->getLinkId(edge));
+	}
+}
+
+// Gives the node a cheaper label and puts it in the frontier, settled or not
+void PathFinder::reopen(int node, double distance, int linkId){
+	forward.frontier.allowAnyKeys();
+	if(forward.settled[node]){
+		forward.settled[node] = false;
+		forward.numSettled--;
+	}
+	if(forward.frontier.contains(node)) forward.frontier.decreaseKey(node, distance);
+	else forward.frontier.enqueue(node, distance);
+	label(forward, node, distance, linkId);
+}
+
+/*
+* Takes the labels of root and of every node labelled through it, found
+* by following the links that are the predecessor link of their other
+* end, then labels each of them again from its settled neighbors.
+*/
+void PathFinder::dropSubtree(int root){
+	forward.frontier.allowAnyKeys();
+	dropped.clear();
+	dropLabels(root);
+	for(int i = 0; i < (int)dropped.size(); i++){
+		int node = dropped[i];
+		for(int edge = graph->firstEdge(node); edge < graph->endEdge(node); edge++)
+			if(forward.predecessorLinks[graph->getTarget(edge)] == graph->getLinkId(edge)) dropLabels(graph->getTarget(edge));
+	}
+	for(int i = 0; i < (int)dropped.size(); i++){
+		int node = dropped[i];
+		double bestDistance = INFINITE_DISTANCE;
+		int bestLink = NO_LINK;
+		for(int edge = graph->firstEdge(node); edge < graph->endEdge(node); edge++){
+			int neighbor = graph->getTarget(edge);
+			double newDistance = forward.distances[neighbor] + graph->getCost(edge);
+			if(forward.settled[neighbor] && newDistance < bestDistance){
+				bestDistance = newDistance;
+				bestLink = graph->getLinkId(edge);
+			}
+		}
+		if(bestLink == NO_LINK) continue;
+		forward.frontier.enqueue(node, bestDistance);
+		label(forward, node, bestDistance, bestLink);
+	}
+}
+
+void PathFinder::dropLabels(int node){
+	if(forward.frontier.contains(node)) forward.frontier.remove(node);
+	if(forward.settled[node]){
+		forward.settled[node] = false;
+		forward.numSettled--;
+	}
+	forward.distances[node] = INFINITE_DISTANCE;
+	forward.predecessorLinks[node] = DROPPED_LINK;
+	dropped.push_back(node);
+}
+
+/*
+* Settles the next node of one side and looks along its links. The best
+* meeting is kept as the node labelled by the forward search, the link
+* and the node labelled by the backward search, whichever side found it.
+*/
+void PathFinder::scanBidirectional(bool fromStart, double &bestCost, int &meetForward, int &meetLink, int &meetBackward){
+	searchLabelsT &side = fromStart ? forward : backward;
+	searchLabelsT &otherSide = fromStart ? backward : forward;
+	int current = side.frontier.dequeueMin();
+	side.settled[current] = true;
+	side.numSettled++;
+	COUNT_STAT(stats.nodesSettled++);
+
+	double currentDistance = side.distances[current];
+	int lastEdge = graph->endEdge(current);
+	COUNT_STAT(stats.edgesRelaxed += lastEdge - graph->firstEdge(current));
+	for(int edge = graph->firstEdge(current); edge < lastEdge; edge++){
+		int neighbor = graph->getTarget(edge);
+		double newDistance = currentDistance + graph->getCost(edge);
+		if(!side.settled[neighbor] && newDistance < side.distances[neighbor]){
+			if(side.frontier.contains(neighbor)) side.frontier.decreaseKey(neighbor, newDistance);
+			else side.frontier.enqueue(neighbor, newDistance);
+			label(side, neighbor, newDistance, graph->getLinkId(edge));
+		}
+		double throughCost = newDistance + otherSide.distances[neighbor];
+		if(throughCost < bestCost){
+			bestCost = throughCost;
+			meetLink = graph->getLinkId(edge);
+			meetForward = fromStart ? current : neighbor;
+			meetBackward = fromStart ? neighbor : current;
+		}
+	}
+}
+
+/*
+* Extends the forward labels across the meeting link and down the
+* backward predecessor links to the end, so that the forward labels
+* alone describe the whole path.
+*/
+void PathFinder::spliceBackwardPath(int meetForward, int meetLink, int meetBackward){
+	int current = meetForward;
+	int next = meetBackward;
+	int linkId = meetLink;
+	while(true){
+		label(forward, next, forward.distances[current] + graph->getLinkCost(linkId), linkId);
+		if(backward.predecessorLinks[next] == NO_LINK) break;
+		current = next;
+		linkId = backward.predecessorLinks[next];
+		next = otherEnd(linkId, next);
+	}
+}
+
+double PathFinder::estimateToEnd(int node, coordT endCoords){
+	double dx = (*coords)[node].x - endCoords.x;
+	double dy = (*coords)[node].y - endCoords.y;
+	return heuristicScale * std::sqrt(dx*dx + dy*dy);
+}
+
+double PathFinder::getDistance(int node){
+	return forward.distances[node];
+}
+
+bool PathFinder::isSettled(int node){
+	return forward.settled[node];
+}
+
+void PathFinder::getPathLinks(int end, std::vector<int> &linkIds){
+	linkIds.clear();
+	int current = end;
+	while(current != source){
+		int linkId = forward.predecessorLinks[current];
+		linkIds.push_back(linkId);
+		current = otherEnd(linkId, current);
+	}
+	std::reverse(linkIds.begin(), linkIds.end());
+}
+
+int PathFinder::otherEnd(int linkId, int node){
+	int linkStart = graph->getLinkStart(linkId);
+	return (linkStart == node) ? graph->getLinkEnd(linkId) : linkStart;
+}
+
+void PathFinder::sizeLabels(searchLabelsT &labels, int numNodes){
+	labels.distances.assign(numNodes, INFINITE_DISTANCE);
+	labels.predecessorLinks.assign(numNodes, NO_LINK);
+	labels.settled.assign(numNodes, false);
+	labels.touched.clear();
+	labels.touched.reserve(numNodes);
+	labels.frontier.reserve(numNodes);
+	labels.numSettled = 0;
+}
+
+// Puts back the labels of only those nodes the previous search changed
+void PathFinder::resetLabels(searchLabelsT &labels){
+	for(int i = 0; i < (int)labels.touched.size(); i++){
+		int node = labels.touched[i];
+		labels.distances[node] = INFINITE_DISTANCE;
+		labels.predecessorLinks[node] = NO_LINK;
+		labels.settled[node] = false;
+	}
+	labels.touched.clear();
+	labels.frontier.clear();
+	labels.numSettled = 0;
+}
+
+void PathFinder::label(searchLabelsT &labels, int node, double distance, int linkId){
+	if(labels.distances[node] == INFINITE_DISTANCE && labels.predecessorLinks[node] != DROPPED_LINK){
+		COUNT_STAT(if(labels.touched.size() == labels.touched.capacity()) stats.allocations++);
+		labels.touched.push_back(node);
+	}
+	labels.distances[node] = distance;
+	labels.predecessorLinks[node] = linkId;
+}
+
+/*
+* Function : calibrateHeuristicScale
+* Usage    : double scale = calibrateHeuristicScale(graph, coords);
+* ---------------------------------------------------------------
+* Works out the largest factor by which the straight line distance 
+* between two nodes can be multiplied and still never exceed the cost of 
+* getting from one to the other: the smallest cost to length ratio over 
+* all links. The result is trimmed a hair so that rounding can't push an 
+* estimate over the true cost. Returns 0 (no estimate) if some link is 
+* free to cross.
+*/
+double calibrateHeuristicScale(const CSRGraph &graph, const std::vector<coordT> &coords){
+	double scale = INFINITE_DISTANCE;
+	for(int linkId = 0; linkId < graph.numLinks(); linkId++){
+		if(graph.isLinkRemoved(linkId)) continue;
+		coordT start = coords[graph.getLinkStart(linkId)];
+		coordT end = coords[graph.getLinkEnd(linkId)];
+		double length = std::sqrt((end.x - start.x)*(end.x - start.x) + (end.y - start.y)*(end.y - start.y));
+		if(length > 0) scale = std::min(scale, graph.getLinkCost(linkId) / length);
+	}
+	if(scale == INFINITE_DISTANCE || scale <= 0) return 0;
+	return scale * (1 - 1e-9);
+}
+
+#endif
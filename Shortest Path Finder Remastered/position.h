@@ -13,6 +13,7 @@
 
 #include "vector.h"
 #include "set.h"
+#include "link.h"
 
 /*
 * A simple structure that holds the x and y coordinates
@@ -27,10 +28,14 @@ class Position{
 public:
 	/*
 	* Function : Constructor function for the Position calss
-	* Usage    : Position samplePos(name of the position, coordinates of the position)
-	* ---------------------------------------------------------------------------------
+	* Usage    : Position samplePos(name of the position, coordinates of the position, id)
+	* -------------------------------------------------------------------------------------
+	* The id is a dense integer (0, 1, 2 ...) handed out by the chart in the
+	* order the positions are added, searches use it to index their labels.
+	* The name is not copied, it points into the name table of the chart
+	* (see nametable.h) which outlives the position.
 	*/
-	Position(string posName, coordT posCoordinates);
+	Position(const char * posName, coordT posCoordinates, int posId);
 
 	/*
 	* Function : getCoordinates
@@ -40,14 +45,14 @@ public:
 	coordT getCoordinates();
 
 	/*
-	* Function : addOriginatingLink
-	* Usage    : samplePos.addOriginatingLink(a pointer to Link object)
-	* ------------------------------------------------------------------
-	* A Position object holds a collection of links that start or end 
-	* at the position, the function is used to add a link to a collection of 
-	* such links of the position.
+	* Function : setOriginatingLinks
+	* Usage    : samplePos.setOriginatingLinks(first link, number of links)
+	* ----------------------------------------------------------------------
+	* A Position object knows the links that start or end at the position, 
+	* they are kept by the chart, all positions' links in one array, and 
+	* the position only points at the count links from first on.
 	*/
-	void addOriginatingLink(Link* origLink);
+	void setOriginatingLinks(Link * const * firstLink, int count);
 
 	/*
 	* Function : getName
@@ -57,27 +62,41 @@ public:
 	string getName();
 
 	/*
-	* Function : getOriginatingLinks
-	* Usage    : Vector<Link*> * neighboringLinks = samplePos.getOriginatingLinks();
-	* -------------------------------------------------------------------------------
+	* Function : getId
+	* Usage    : int samplePosId = samplePos.getId();
+	* ------------------------------------------------
 	*/
-	Vector<Link*> * getOriginatingLinks();
+	int getId();
+
+	/*
+	* Function : numOriginatingLinks, getOriginatingLink
+	* Usage    : Link * neighboringLink = samplePos.getOriginatingLink(i);
+	* -----------------------------------------------------------------
+	* The links that start or end at the position, i goes from 0 to 
+	* numOriginatingLinks()-1.
+	*/
+	int numOriginatingLinks();
+	Link * getOriginatingLink(int index);
 
 private :
-	string name;
+	const char * name;
+	int id;
 	coordT coordinates;
-	Vector<Link*> originatingLinks; // Links that originate from the current Position
+	Link * const * originatingLinks; // Links that originate from the current Position
+	int originatingLinkCount;
 };
 
-#endif
-
-Position::Position(string posName, coordT posCoordinates){
+Position::Position(const char * posName, coordT posCoordinates, int posId){
 	name = posName;
+	id = posId;
 	coordinates = posCoordinates;
+	originatingLinks = NULL;
+	originatingLinkCount = 0;
 }
 
-void Position::addOriginatingLink(Link* origLink){
-	originatingLinks.add(origLink);
+void Position::setOriginatingLinks(Link * const * firstLink, int count){
+	originatingLinks = firstLink;
+	originatingLinkCount = count;
 }
 
 coordT Position::getCoordinates(){
@@ -88,6 +107,16 @@ string Position::getName(){
 	return name;
 }
 
-Vector<Link *> * Position::getOriginatingLinks(){
-	return &originatingLinks;
+int Position::getId(){
+	return id;
 }
+
+int Position::numOriginatingLinks(){
+	return originatingLinkCount;
+}
+
+Link * Position::getOriginatingLink(int index){
+	return originatingLinks[index];
+}
+
+#endif
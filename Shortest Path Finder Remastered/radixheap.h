@@ -0,0 +1,261 @@
+/*
+* File : radixheap.h
+* -------------------
+* Defines the RadixHeap class, a min heap over integer ids (0 to
+* capacity-1) with whole number keys, for Dijkstra on charts whose link
+* costs are all whole numbers. It offers the same operations as
+* IndexedHeap, with one condition: it is monotone, no key given to it
+* may be smaller than the last key taken off it. Dijkstra never breaks
+* that since every node it queues is at least as far as the one it
+* just settled.
+*
+* Implementation notes
+* ---------------------
+* The ids are kept in 65 buckets by how their key compares to the last
+* key taken off the heap (lastMin): bucket 0 holds the keys equal to it,
+* bucket b those whose highest bit differing from lastMin is bit b-1.
+* The keys in bucket b all lie below those in any higher bucket, so the
+* minimum sits in the lowest non empty bucket. Taking it off empties
+* that bucket into lower ones (every key in it now differs from the new
+* lastMin in a lower bit), and since a key can only ever move down the
+* buckets, every id is moved at most 64 times, making each operation
+* constant time on average with no key comparisons but the scan for the
+* minimum. Each id remembers its bucket and its slot in it, so lowering
+* a key takes it out of its bucket in one step.
+*/
+
+#ifndef RADIX_HEAP_H
+#define RADIX_HEAP_H
+
+#include <vector>
+#include "genlib.h"
+#include "searchstats.h"
+
+class RadixHeap{
+public:
+	/*
+	* Function : Constructor function for the RadixHeap class
+	* Usage    : RadixHeap heap(numIds);
+	* -----------------------------------
+	* Ids passed to the heap must lie in the range 0 to capacity-1.
+	*/
+	RadixHeap(int capacity = 0);
+
+	/*
+	* Function : reserve
+	* Usage    : heap.reserve(numIds);
+	* ---------------------------------
+	* Makes room for ids 0 to capacity-1. Empties the heap.
+	*/
+	void reserve(int capacity);
+
+	/*
+	* Function : enqueue, decreaseKey
+	* Usage    : heap.enqueue(id, key);
+	* ----------------------------------
+	* enqueue adds an id that isn't in the heap, decreaseKey lowers the
+	* key of one that is. Neither key may be below the last key taken
+	* off the heap.
+	*/
+	void enqueue(int id, unsigned long long key);
+	void decreaseKey(int id, unsigned long long key);
+
+	bool contains(int id);
+	unsigned long long getKey(int id);
+
+	/*
+	* Function : peekMinKey, dequeueMin
+	* Usage    : int id = heap.dequeueMin();
+	* ---------------------------------------
+	* The smallest key, and the removal of an id holding it. Both call
+	* Error if the heap is empty.
+	*/
+	unsigned long long peekMinKey();
+	int dequeueMin();
+
+	/*
+	* Function : remove
+	* Usage    : heap.remove(id);
+	* ----------------------------
+	* Takes an id that is in the heap out of it, whatever its key.
+	*/
+	void remove(int id);
+
+	/*
+	* Function : clear
+	* Usage    : heap.clear();
+	* -------------------------
+	* Empties the heap and starts the keys over from 0, costs time
+	* proportional to the number of ids left in it.
+	*/
+	void clear();
+
+	int size();
+	bool isEmpty();
+
+	/*
+	* Function : getStats, clearStats
+	* Usage    : addStats(total, heap.getStats());
+	* ---------------------------------------------
+	* As for IndexedHeap, comparisons are those made looking for the
+	* minimum of a bucket.
+	*/
+	const searchStatsT & getStats();
+	void clearStats();
+
+private:
+	static const int NUM_BUCKETS = 65;
+	std::vector<int> buckets[NUM_BUCKETS];
+	std::vector<unsigned long long> keys;  // key of every id in the heap
+	std::vector<int> bucketOf;             // bucket of every id, -1 if absent
+	std::vector<int> slotOf;               // where every id sits in its bucket
+	unsigned long long lastMin;
+	int count;
+	searchStatsT stats;
+
+	int bucketIndex(unsigned long long key);
+	void place(int id);
+	void removeFromBucket(int id);
+	void fillFirstBucket();
+};
+
+RadixHeap::RadixHeap(int capacity){
+	stats = NO_SEARCH_STATS;
+	lastMin = 0;
+	count = 0;
+	reserve(capacity);
+}
+
+void RadixHeap::reserve(int capacity){
+	for(int b = 0; b < NUM_BUCKETS; b++)
+		buckets[b].clear();
+	keys.assign(capacity, 0);
+	bucketOf.assign(capacity, -1);
+	slotOf.assign(capacity, 0);
+	lastMin = 0;
+	count = 0;
+}
+
+void RadixHeap::enqueue(int id, unsigned long long key){
+	keys[id] = key;
+	place(id);
+	count++;
+	COUNT_STAT(stats.heapPushes++);
+	COUNT_STAT(if(count > stats.heapPeakSize) stats.heapPeakSize = count);
+}
+
+void RadixHeap::decreaseKey(int id, unsigned long long key){
+	keys[id] = key;
+	int bucket = bucketIndex(key);
+	if(bucket == bucketOf[id]) return;
+	removeFromBucket(id);
+	place(id);
+}
+
+bool RadixHeap::contains(int id){
+	return bucketOf[id] != -1;
+}
+
+unsigned long long RadixHeap::getKey(int id){
+	return keys[id];
+}
+
+unsigned long long RadixHeap::peekMinKey(){
+	if(count == 0) Error("peekMinKey called on an empty heap");
+	fillFirstBucket();
+	return lastMin;
+}
+
+int RadixHeap::dequeueMin(){
+	if(count == 0) Error("dequeueMin called on an empty heap");
+	fillFirstBucket();
+	int minId = buckets[0].back();
+	buckets[0].pop_back();
+	bucketOf[minId] = -1;
+	count--;
+	COUNT_STAT(stats.heapPops++);
+	return minId;
+}
+
+void RadixHeap::remove(int id){
+	removeFromBucket(id);
+	count--;
+}
+
+void RadixHeap::clear(){
+	for(int b = 0; b < NUM_BUCKETS; b++){
+		for(int i = 0; i < (int)buckets[b].size(); i++)
+			bucketOf[buckets[b][i]] = -1;
+		buckets[b].clear();
+	}
+	lastMin = 0;
+	count = 0;
+}
+
+int RadixHeap::size(){
+	return count;
+}
+
+bool RadixHeap::isEmpty(){
+	return count == 0;
+}
+
+const searchStatsT & RadixHeap::getStats(){
+	return stats;
+}
+
+void RadixHeap::clearStats(){
+	stats = NO_SEARCH_STATS;
+}
+
+// 0 if the key equals lastMin, otherwise one more than the highest bit in which they differ
+int RadixHeap::bucketIndex(unsigned long long key){
+	unsigned long long differing = key ^ lastMin;
+	int bucket = 0;
+	for(int shift = 32; shift > 0; shift /= 2){
+		if(differing >> shift){
+			differing >>= shift;
+			bucket += shift;
+		}
+	}
+	return bucket + (int)differing;
+}
+
+void RadixHeap::place(int id){
+	int bucket = bucketIndex(keys[id]);
+	COUNT_STAT(if(buckets[bucket].size() == buckets[bucket].capacity()) stats.allocations++);
+	bucketOf[id] = bucket;
+	slotOf[id] = buckets[bucket].size();
+	buckets[bucket].push_back(id);
+}
+
+// The last id of the bucket takes the place of the one removed
+void RadixHeap::removeFromBucket(int id){
+	std::vector<int> &bucket = buckets[bucketOf[id]];
+	int lastId = bucket.back();
+	bucket[slotOf[id]] = lastId;
+	slotOf[lastId] = slotOf[id];
+	bucket.pop_back();
+	bucketOf[id] = -1;
+}
+
+// Makes sure bucket 0 holds the minimum, by emptying the lowest non empty bucket into lower ones
+void RadixHeap::fillFirstBucket(){
+	if(!buckets[0].empty()) return;
+	int lowest = 1;
+	while(buckets[lowest].empty()) lowest++;
+	std::vector<int> &bucket = buckets[lowest];
+	unsigned long long newMin = keys[bucket[0]];
+	for(int i = 1; i < (int)bucket.size(); i++)
+		if(keys[bucket[i]] < newMin) newMin = keys[bucket[i]];
+	COUNT_STAT(stats.comparisons += bucket.size() - 1);
+	lastMin = newMin;
+	std::vector<int> moving;
+	moving.swap(bucket);
+	for(int i = 0; i < (int)moving.size(); i++)
+		place(moving[i]);
+	moving.clear();
+	moving.swap(bucket);
+}
+
+#endif
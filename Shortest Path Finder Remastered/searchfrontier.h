@@ -0,0 +1,172 @@
+/*
+* File : searchfrontier.h
+* ------------------------
+* Defines the SearchFrontier class, the frontier of a PathFinder search.
+* It is an IndexedHeap, unless it is told its keys are whole numbers
+* that never go below the last one taken off (a Dijkstra search on a
+* graph whose costs are all whole numbers, see CSRGraph::hasIntegerCosts)
+* in which case it is a RadixHeap. Searches go through the same calls
+* either way. Each heap is only given room for the graph the first time
+* it is picked, so a PathFinder that only ever runs on whole number
+* costs never sizes the IndexedHeap and the other way round.
+*/
+
+#ifndef SEARCH_FRONTIER_H
+#define SEARCH_FRONTIER_H
+
+#include <vector>
+#include "indexedheap.h"
+#include "radixheap.h"
+#include "searchstats.h"
+
+class SearchFrontier{
+public:
+	SearchFrontier();
+
+	/*
+	* Function : useIntegerKeys
+	* Usage    : frontier.useIntegerKeys(graph.hasIntegerCosts());
+	* ------------------------------------------------------------
+	* Picks the heap for the next search, the frontier must be empty.
+	*/
+	void useIntegerKeys(bool integerKeys);
+
+	/*
+	* Function : allowAnyKeys
+	* Usage    : frontier.allowAnyKeys();
+	* ------------------------------------
+	* Moves whatever the frontier holds into the IndexedHeap, if it was
+	* in the RadixHeap, so that keys below the last one taken off may be
+	* given to it from then on. For searches that are repaired after the
+	* graph changed (see PathFinder::repairSearch), lasts until the next
+	* useIntegerKeys.
+	*/
+	void allowAnyKeys();
+
+	/*
+	* Function : reserve
+	* Usage    : frontier.reserve(numNodes);
+	* ---------------------------------------
+	* Ids will lie in the range 0 to capacity-1. Empties the frontier.
+	*/
+	void reserve(int capacity);
+
+	// Same as for IndexedHeap
+	void enqueue(int id, double key);
+	void decreaseKey(int id, double key);
+	bool contains(int id);
+	double peekMinKey();
+	int dequeueMin();
+	void remove(int id);
+	void clear();
+	int size();
+	bool isEmpty();
+	searchStatsT getStats();
+	void clearStats();
+
+private:
+	bool integer;
+	int capacity;
+	IndexedHeap<double> heap;
+	RadixHeap radixHeap;
+	int heapCapacity;                // capacity each heap was last sized for, -1 if never
+	int radixCapacity;
+
+	void sizeHeapInUse();
+};
+
+SearchFrontier::SearchFrontier(){
+	integer = false;
+	capacity = 0;
+	heapCapacity = radixCapacity = -1;
+}
+
+void SearchFrontier::useIntegerKeys(bool integerKeys){
+	integer = integerKeys;
+	sizeHeapInUse();
+}
+
+void SearchFrontier::allowAnyKeys(){
+	if(!integer) return;
+	std::vector<int> ids;
+	std::vector<double> keys;
+	while(!radixHeap.isEmpty()){
+		keys.push_back((double)radixHeap.peekMinKey());
+		ids.push_back(radixHeap.dequeueMin());
+	}
+	integer = false;
+	sizeHeapInUse();
+	for(int i = 0; i < (int)ids.size(); i++)
+		heap.enqueue(ids[i], keys[i]);
+}
+
+void SearchFrontier::reserve(int numIds){
+	capacity = numIds;
+	heapCapacity = radixCapacity = -1;
+	heap.clear();
+	radixHeap.clear();
+	sizeHeapInUse();
+}
+
+void SearchFrontier::enqueue(int id, double key){
+	if(integer) radixHeap.enqueue(id, (unsigned long long)key);
+	else heap.enqueue(id, key);
+}
+
+void SearchFrontier::decreaseKey(int id, double key){
+	if(integer) radixHeap.decreaseKey(id, (unsigned long long)key);
+	else heap.decreaseKey(id, key);
+}
+
+bool SearchFrontier::contains(int id){
+	return integer ? radixHeap.contains(id) : heap.contains(id);
+}
+
+double SearchFrontier::peekMinKey(){
+	return integer ? (double)radixHeap.peekMinKey() : heap.peekMinKey();
+}
+
+int SearchFrontier::dequeueMin(){
+	return integer ? radixHeap.dequeueMin() : heap.dequeueMin();
+}
+
+void SearchFrontier::remove(int id){
+	if(integer) radixHeap.remove(id);
+	else heap.remove(id);
+}
+
+void SearchFrontier::clear(){
+	heap.clear();
+	radixHeap.clear();
+}
+
+int SearchFrontier::size(){
+	return integer ? radixHeap.size() : heap.size();
+}
+
+bool SearchFrontier::isEmpty(){
+	return integer ? radixHeap.isEmpty() : heap.isEmpty();
+}
+
+searchStatsT SearchFrontier::getStats(){
+	searchStatsT total = heap.getStats();
+	addStats(total, radixHeap.getStats());
+	return total;
+}
+
+void SearchFrontier::clearStats(){
+	heap.clearStats();
+	radixHeap.clearStats();
+}
+
+void SearchFrontier::sizeHeapInUse(){
+	if(integer && radixCapacity != capacity){
+		radixHeap.reserve(capacity);
+		radixCapacity = capacity;
+	}else if(!integer && heapCapacity != capacity){
+		heap.reserve(capacity);
+		heapCapacity = capacity;
+	}
+}
+
+#endif
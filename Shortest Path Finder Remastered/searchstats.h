@@ -0,0 +1,69 @@
+/*
+* File : searchstats.h
+* ---------------------
+* Defines searchStatsT, the counters that tell what a search (or the
+* spanning tree) spent its time on, and the COUNT_STAT macro that every
+* counting statement is wrapped in.
+*
+* Counting is opt in: only when the program is compiled with
+* COLLECT_SEARCH_STATS defined (e.g. /D COLLECT_SEARCH_STATS) does
+* COUNT_STAT keep its statement, otherwise it expands to nothing and the
+* searches compile exactly as if the counters weren't there. The
+* functions that hand back statistics are there either way and report
+* zeros when counting is off.
+*/
+
+#ifndef SEARCH_STATS_H
+#define SEARCH_STATS_H
+
+#ifdef COLLECT_SEARCH_STATS
+#define COUNT_STAT(statement) statement
+#else
+#define COUNT_STAT(statement)
+#endif
+
+/*
+* nodesSettled   : nodes taken off a frontier for good
+* edgesRelaxed   : edges (or links, for the spanning tree) looked along
+* heapPushes, heapPops, heapPeakSize : traffic on the frontier heaps
+* comparisons    : key comparisons made by the heaps
+* allocations    : times a scratch array had to grow during the work
+* setupSeconds   : wall time spent clearing what the last search left
+* searchSeconds  : wall time spent searching
+* pathSeconds    : wall time spent turning the result into a Path
+*/
+struct searchStatsT{
+	long long nodesSettled;
+	long long edgesRelaxed;
+	long long heapPushes;
+	long long heapPops;
+	long long heapPeakSize;
+	long long comparisons;
+	long long allocations;
+	double setupSeconds;
+	double searchSeconds;
+	double pathSeconds;
+};
+
+const searchStatsT NO_SEARCH_STATS = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+/*
+* Function : addStats
+* Usage    : addStats(total, queryStats);
+* ----------------------------------------
+* Adds part to total, the peak heap size is the larger of the two.
+*/
+void addStats(searchStatsT &total, const searchStatsT &part){
+	total.nodesSettled += part.nodesSettled;
+	total.edgesRelaxed += part.edgesRelaxed;
+	total.heapPushes += part.heapPushes;
+	total.heapPops += part.heapPops;
+	if(part.heapPeakSize > total.heapPeakSize) total.heapPeakSize = part.heapPeakSize;
+	total.comparisons += part.comparisons;
+	total.allocations += part.allocations;
+	total.setupSeconds += part.setupSeconds;
+	total.searchSeconds += part.searchSeconds;
+	total.pathSeconds += part.pathSeconds;
+}
+
+#endif
@@ -0,0 +1,199 @@
+/*
+* File : searchtreecache.h
+* -------------------------
+* Defines the SearchTreeCache class which keeps the shortest path trees
+* of the most recently used start positions around, so that queries
+* sharing a start don't search from scratch every time.
+*
+* Implementation notes
+* ---------------------
+* Every slot of the cache is a PathFinder holding a Dijkstra search from
+* one start that is paused as soon as the end of the query that caused
+* it was settled (see PathFinder::resumeSearch). A later query from the
+* same start either finds its end settled already and just walks the
+* predecessor links, or resumes the paused search until it is. When a
+* start that isn't cached comes along, the slot used longest ago is
+* given to it. The slot of every cached start is looked up through an
+* array indexed by node id, and slots are only sized for the graph the
+* first time they are used. When a link of the graph changes every
+* cached tree is repaired where it stands (see PathFinder::repairSearch).
+*
+* Every tree has labels for the whole graph, so the number of slots is
+* worked out from a memory budget when the graph is set: as many trees
+* as fit in it at TREE_BYTES_PER_NODE each, at most MAX_TREE_CACHE_SIZE.
+* The default budget keeps 16 trees of charts up to about 130000
+* positions and a couple of a million, and none of ten million, in
+* which case the cache holds nothing and the chart searches without it.
+*/
+
+#ifndef SEARCH_TREE_CACHE_H
+#define SEARCH_TREE_CACHE_H
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include "csrgraph.h"
+#include "pathfinder.h"
+
+const int MAX_TREE_CACHE_SIZE = 16;
+const long DEFAULT_TREE_CACHE_BYTES = 64L * 1024 * 1024;
+
+// Most a cached tree takes per node: distance, predecessor, heap entry and slot
+const int TREE_BYTES_PER_NODE = 32;
+
+class SearchTreeCache{
+public:
+	/*
+	* Function : Constructor function for the SearchTreeCache class
+	* Usage    : SearchTreeCache cache(memoryBudget);
+	* ------------------------------------------------
+	* The cached trees will take at most memoryBudget bytes, 0 keeps
+	* none (see the implementation notes).
+	*/
+	SearchTreeCache(long memoryBudget = DEFAULT_TREE_CACHE_BYTES);
+
+	/*
+	* Function : setGraph
+	* Usage    : cache.setGraph(&graph);
+	* -----------------------------------
+	* Points the cache at a (new) graph, which forgets every cached tree
+	* and works out how many trees of that graph fit in the budget.
+	*/
+	void setGraph(const CSRGraph * searchGraph);
+
+	/*
+	* Function : getCapacity
+	* Usage    : if(cache.getCapacity() > 0) ...
+	* -------------------------------------------
+	* Number of trees the cache keeps for the graph it was given, when it
+	* is 0 findShortestPath must not be called.
+	*/
+	int getCapacity();
+
+	/*
+	* Function : clear
+	* Usage    : cache.clear();
+	* --------------------------
+	* Forgets every cached tree.
+	*/
+	void clear();
+
+	/*
+	* Function : repair
+	* Usage    : cache.repair(linkId, oldCost, newCost);
+	* ---------------------------------------------------
+	* To be called whenever a link of the graph was added (oldCost
+	* INFINITE_DISTANCE), removed (newCost INFINITE_DISTANCE) or given a
+	* new cost, brings every cached tree in line with the change.
+	*/
+	void repair(int linkId, double oldCost, double newCost);
+
+	/*
+	* Function : findShortestPath
+	* Usage    : if(cache.findShortestPath(startId, endId, linkIds)) ...
+	* ---------------------------------------------------------------
+	* Fills linkIds with the ids of the links of a shortest path from
+	* start to end, in order from the start. Returns false if end can't
+	* be reached.
+	*/
+	bool findShortestPath(int start, int end, std::vector<int> &linkIds);
+
+	int numCached();
+
+	/*
+	* Function : getStats
+	* Usage    : searchStatsT stats = cache.getStats();
+	* --------------------------------------------------
+	* What the last query did, see PathFinder::getStats. A query that
+	* found its end settled already did nothing.
+	*/
+	searchStatsT getStats();
+
+private:
+	const CSRGraph * graph;
+	long budget;
+	std::vector<PathFinder> trees;
+	std::vector<int> treeSources;    // start of the tree in each slot, -1 if free
+	std::vector<long> lastUsed;      // when each slot was last used
+	std::vector<int> slotOfSource;   // indexed by node id, -1 if not cached
+	long useCount;
+	int lastSlot;                    // slot used by the last query
+
+	int findSlot(int start);
+};
+
+SearchTreeCache::SearchTreeCache(long memoryBudget){
+	graph = NULL;
+	budget = memoryBudget;
+	useCount = 0;
+	lastSlot = -1;
+}
+
+void SearchTreeCache::setGraph(const CSRGraph * searchGraph){
+	graph = searchGraph;
+	double treeBytes = (double)TREE_BYTES_PER_NODE * std::max(graph->numNodes(), 1);
+	int capacity = (int)std::min((double)MAX_TREE_CACHE_SIZE, floor(budget / treeBytes));
+	slotOfSource.assign(graph->numNodes(), -1);
+	treeSources.assign(capacity, -1);
+	lastUsed.assign(capacity, 0);
+	trees.assign(capacity, PathFinder());
+	lastSlot = -1;
+}
+
+int SearchTreeCache::getCapacity(){
+	return trees.size();
+}
+
+void SearchTreeCache::clear(){
+	for(int i = 0; i < (int)treeSources.size(); i++){
+		if(treeSources[i] != -1) slotOfSource[treeSources[i]] = -1;
+		treeSources[i] = -1;
+		lastUsed[i] = 0;
+	}
+}
+
+void SearchTreeCache::repair(int linkId, double oldCost, double newCost){
+	for(int i = 0; i < (int)treeSources.size(); i++)
+		if(treeSources[i] != -1) trees[i].repairSearch(linkId, oldCost, newCost);
+}
+
+bool SearchTreeCache::findShortestPath(int start, int end, std::vector<int> &linkIds){
+	lastSlot = findSlot(start);
+	PathFinder &tree = trees[lastSlot];
+	linkIds.clear();
+	if(!tree.resumeSearch(end)) return false;
+	tree.getPathLinks(end, linkIds);
+	return true;
+}
+
+searchStatsT SearchTreeCache::getStats(){
+	if(lastSlot == -1) return NO_SEARCH_STATS;
+	return trees[lastSlot].getStats();
+}
+
+int SearchTreeCache::numCached(){
+	int count = 0;
+	for(int i = 0; i < (int)treeSources.size(); i++)
+		if(treeSources[i] != -1) count++;
+	return count;
+}
+
+// The slot holding the tree of start, set up (in the slot used longest ago) if there is none
+int SearchTreeCache::findSlot(int start){
+	useCount++;
+	int slot = slotOfSource[start];
+	if(slot == -1){
+		slot = 0;
+		for(int i = 1; i < (int)lastUsed.size(); i++)
+			if(lastUsed[i] < lastUsed[slot]) slot = i;
+		if(treeSources[slot] != -1) slotOfSource[treeSources[slot]] = -1;
+		if(trees[slot].getGraph() != graph) trees[slot].setGraph(graph);
+		trees[slot].startSearch(start);
+		treeSources[slot] = start;
+		slotOfSource[start] = slot;
+	}
+	lastUsed[slot] = useCount;
+	return slot;
+}
+
+#endif
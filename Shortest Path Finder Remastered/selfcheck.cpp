@@ -0,0 +1,1144 @@
+/*
+* File : selfcheck.cpp
+* ---------------------
+* A command line program that checks the path finder against plain,
+* independent implementations on made up charts (see chartgenerator.h).
+*
+* Usage : selfcheck [-s seed]
+*
+* The checks are
+*
+* search modes         every search mode of Chart finds a path of the
+*                      same cost as a textbook Dijkstra, and the path
+*                      runs from the start to the end
+* k shortest paths     KShortestPaths finds exactly the cheapest loopless
+*                      paths, compared with listing every loopless path
+*                      of small charts, and Chart hands them back
+*                      cheapest first with no position passed twice
+* link edits           after random setLinkCost, addLinkBetween and
+*                      removeLink calls the repaired search tree cache
+*                      and every search mode still agree with Dijkstra
+*                      on the chart as edited
+* compiled files       a compiled chart (.bin) and a saved hierarchy
+*                      (.ch) read back what was written, the same
+*                      hierarchy saves to the same bytes, and damaged
+*                      files are refused
+* tree cache budgets   queries agree with Dijkstra with the search tree
+*                      cache off, holding one tree or the default, and
+*                      the budget decides how many trees are kept
+* spanning trees       getMinimalSpanningTree in every mode picks links
+*                      that close no cycle, join every position
+*                      Kruskal's algorithm on the reference does and
+*                      cost as much, also once links were removed and
+*                      parallel links and loops added
+* distance matrix      getDistanceMatrix agrees with Dijkstra from every
+*                      source, also where there is no path and once
+*                      links were edited
+* search budgets       searchPathBetween, with no budget and with a
+*                      budget on the cost, the links or the positions
+*                      settled, hands back the status and path that
+*                      Dijkstra and breadth first search call for
+* reachable within     getReachableWithin hands back the positions and
+*                      links within the budget that Dijkstra finds,
+*                      nearest first with the right costs, also with
+*                      whole number costs where many sit on the budget
+* spatial index        SpatialIndex and the Chart functions on top of it
+*                      find the nearest position and the positions
+*                      within a radius that looking at every position
+*                      finds, for points spread, bunched up, repeated,
+*                      on a line, alone or missing
+* chart parser         a data file with blank lines, tabs and \r\n line
+*                      ends reads back what it holds, and malformed
+*                      files are reported with the right line number
+*                      and message (the parser runs in a selfcheck of
+*                      its own, started with -parse, since Error ends
+*                      the program)
+* name table           NameTable finds every name it was given under its
+*                      id and no other, for names that are prefixes of
+*                      one another or hold a '\0', also once handed to
+*                      another table
+*
+* The charts are written to selfcheck_*.txt in the current directory
+* and removed at the end, with their compiled files. Every failure is
+* printed, the program ends with the number of checks that failed and
+* returns 1 if any did. It has its own main and is built as a separate
+* console program, like benchmark.cpp: selfcheck.vcproj in the solution,
+* or elsewhere
+*
+*     g++ -O2 -fopenmp -I<CS106 include dir> -o selfcheck selfcheck.cpp
+*/
+
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <queue>
+#include <functional>
+#include <algorithm>
+#include "chart.h"
+#include "chartgenerator.h"
+#include "kshortestpaths.h"
+
+int numChecks = 0;
+int numFailed = 0;
+
+// Counts a check, prints what was checked if it failed
+void expect(bool passed, string what){
+	numChecks++;
+	if(passed) return;
+	numFailed++;
+	cout<<"FAILED : "<<what<<endl;
+}
+
+bool sameCost(double one, double two){
+	if(one == INFINITE_DISTANCE || two == INFINITE_DISTANCE) return one == two;
+	return fabs(one - two) <= 1e-9 * std::max(1.0, fabs(two));
+}
+
+string positionName(int posId){
+	char name[16];
+	sprintf(name, "p%d", posId);
+	return name;
+}
+
+string describe(string check, int start, int end){
+	char where[64];
+	sprintf(where, " from p%d to p%d", start, end);
+	return check + where;
+}
+
+/*
+* The links of a chart as the checks know them, kept apart from
+* everything the path finder builds so that both can't be wrong the
+* same way.
+*/
+struct referenceLinksT{
+	int numPositions;
+	std::vector<int> starts, ends;
+	std::vector<double> costs;
+	std::vector<bool> removed;
+};
+
+void initReference(referenceLinksT &reference, const ChartData &data){
+	reference.numPositions = data.numPositions();
+	reference.starts = data.linkStarts;
+	reference.ends = data.linkEnds;
+	reference.costs = data.linkCosts;
+	reference.removed.assign(data.numLinks(), false);
+}
+
+// Textbook Dijkstra with a lazy std::priority_queue, fills the distance to every position
+void referenceDistances(const referenceLinksT &reference, int start, std::vector<double> &distances){
+	int numPositions = reference.numPositions;
+	std::vector<std::vector<int> > linksOf(numPositions);
+	for(int i = 0; i < (int)reference.starts.size(); i++){
+		if(reference.removed[i]) continue;
+		linksOf[reference.starts[i]].push_back(i);
+		linksOf[reference.ends[i]].push_back(i);
+	}
+	typedef std::pair<double, int> queuedT;
+	std::priority_queue<queuedT, std::vector<queuedT>, std::greater<queuedT> > queue;
+	distances.assign(numPositions, INFINITE_DISTANCE);
+	distances[start] = 0;
+	queue.push(queuedT(0, start));
+	while(!queue.empty()){
+		queuedT top = queue.top();
+		queue.pop();
+		int node = top.second;
+		if(top.first > distances[node]) continue;
+		for(int i = 0; i < (int)linksOf[node].size(); i++){
+			int linkId = linksOf[node][i];
+			int neighbor = (reference.starts[linkId] == node) ? reference.ends[linkId] : reference.starts[linkId];
+			double distance = distances[node] + reference.costs[linkId];
+			if(distance < distances[neighbor]){
+				distances[neighbor] = distance;
+				queue.push(queuedT(distance, neighbor));
+			}
+		}
+	}
+}
+
+/*
+* Walks the links of the path from the start, returns true if each one
+* carries on from where the last one ended, none of them is removed,
+* the walk ends at the end and, if loopless is set, no position is
+* passed twice.
+*/
+bool isPathBetween(Path &path, int start, int end, const referenceLinksT &reference, bool loopless){
+	int current = start;
+	std::vector<bool> passed(reference.numPositions, false);
+	passed[start] = true;
+	for(int i = 0; i < path.lengthInLinks(); i++){
+		int linkId = path.getAt(i)->getId();
+		if(linkId >= (int)reference.removed.size() || reference.removed[linkId]) return false;
+		if(reference.starts[linkId] == current) current = reference.ends[linkId];
+		else if(reference.ends[linkId] == current) current = reference.starts[linkId];
+		else return false;
+		if(loopless && passed[current]) return false;
+		passed[current] = true;
+	}
+	return current == end;
+}
+
+// Writes a made up chart to a text file and reads it back the way Chart will
+string makeChart(graphKindT kind, int numPositions, unsigned int seed, ChartData &data, bool integerCosts = false){
+	string fileName = "selfcheck_" + graphKindName(kind) + ".txt";
+	remove(compiledChartName(fileName).c_str());
+	remove(hierarchyFileName(fileName).c_str());
+	ChartData generated;
+	generateChart(kind, numPositions, seed, generated);
+	// Whole number costs make the searches use the radix heap
+	for(int i = 0; integerCosts && i < generated.numLinks(); i++)
+		generated.linkCosts[i] = floor(generated.linkCosts[i]);
+	if(!writeChartText(fileName, generated)) Error("Can't write " + fileName);
+	// Costs go through the text file rounded, so the checks use what is read back
+	ChartParser parser;
+	parser.parseFile(fileName, data);
+	return fileName;
+}
+
+void removeChartFiles(string fileName){
+	remove(fileName.c_str());
+	remove(compiledChartName(fileName).c_str());
+	remove(hierarchyFileName(fileName).c_str());
+}
+
+/*
+* Checks every search mode of the chart against the reference between
+* a start and some random ends, the hierarchy too if withHierarchy is
+* set (it is built again after every change to the links).
+*/
+void checkQueries(Chart &chart, const referenceLinksT &reference, int start, int numEnds, RandomStream &random, bool withHierarchy = true){
+	searchModeT modes[] = {DIJKSTRA_SEARCH, ASTAR_SEARCH, BIDIRECTIONAL_SEARCH, HIERARCHY_SEARCH};
+	string modeNames[] = {"dijkstra", "astar", "bidirectional", "hierarchy"};
+	std::vector<double> distances;
+	referenceDistances(reference, start, distances);
+	for(int i = 0; i < numEnds; i++){
+		int end = (int)(random.nextDouble() * reference.numPositions);
+		for(int m = 0; m < (withHierarchy ? 4 : 3); m++){
+			Path path = chart.getShortestPathBetween(positionName(start), positionName(end), modes[m]);
+			bool found = path.lengthInLinks() > 0 || start == end;
+			double cost = found ? path.getTotalPathCost() : INFINITE_DISTANCE;
+			expect(sameCost(cost, distances[end]), describe(modeNames[m] + " path cost", start, end));
+			if(found) expect(isPathBetween(path, start, end, reference, false), describe(modeNames[m] + " path links", start, end));
+		}
+	}
+}
+
+void checkSearchModes(unsigned int seed){
+	graphKindT kinds[] = {GRID_GRAPH, GEOMETRIC_GRAPH, ROAD_GRAPH};
+	for(int k = 0; k < 3; k++){
+		ChartData data;
+		string fileName = makeChart(kinds[k], 3000, seed + k, data);
+		referenceLinksT reference;
+		initReference(reference, data);
+		int before = numFailed;
+		{
+			Chart chart(fileName);
+			RandomStream random(seed + k);
+			for(int i = 0; i < 20; i++)
+				checkQueries(chart, reference, (int)(random.nextDouble() * reference.numPositions), 10, random);
+		}
+		removeChartFiles(fileName);
+		cout<<"search modes on "<<graphKindName(kinds[k])<<" : "<<(numFailed == before ? "ok" : "FAILED")<<endl;
+	}
+}
+
+// Lists the cost of every loopless path from node to end, by depth first search
+void listPathCosts(const CSRGraph &graph, int node, int end, double cost, std::vector<bool> &onPath, std::vector<double> &costs){
+	if(node == end){
+		costs.push_back(cost);
+		return;
+	}
+	onPath[node] = true;
+	for(int edge = graph.firstEdge(node); edge < graph.endEdge(node); edge++){
+		int target = graph.getTarget(edge);
+		if(!onPath[target]) listPathCosts(graph, target, end, cost + graph.getCost(edge), onPath, costs);
+	}
+	onPath[node] = false;
+}
+
+void checkKShortestPaths(unsigned int seed){
+	int before = numFailed;
+	RandomStream random(seed);
+	// Small random multigraphs, with self loops and parallel links, have few enough paths to list them all
+	for(int graphNum = 0; graphNum < 300; graphNum++){
+		int numNodes = 4 + (int)(random.nextDouble() * 8);
+		int numLinks = numNodes + (int)(random.nextDouble() * 2 * numNodes);
+		bool integerCosts = (graphNum % 2 == 0);
+		std::vector<int> starts, ends;
+		std::vector<double> costs;
+		for(int i = 0; i < numLinks; i++){
+			starts.push_back((int)(random.nextDouble() * numNodes));
+			ends.push_back((int)(random.nextDouble() * numNodes));
+			double cost = random.nextDouble() * 5;
+			costs.push_back(integerCosts ? floor(cost) : cost);
+		}
+		CSRGraph graph;
+		graph.build(numNodes, starts, ends, costs);
+		KShortestPaths kShortestPaths(&graph);
+		for(int query = 0; query < 5; query++){
+			int start = (int)(random.nextDouble() * numNodes);
+			int end = (int)(random.nextDouble() * numNodes);
+			std::vector<double> allCosts;
+			std::vector<bool> onPath(numNodes, false);
+			listPathCosts(graph, start, end, 0, onPath, allCosts);
+			std::sort(allCosts.begin(), allCosts.end());
+			int numPaths = 1 + (int)(random.nextDouble() * 12);
+			int numFound = kShortestPaths.findPaths(start, end, numPaths);
+			expect(numFound == std::min(numPaths, (int)allCosts.size()), describe("number of k shortest paths", start, end));
+			for(int i = 0; i < numFound && i < (int)allCosts.size(); i++)
+				expect(sameCost(kShortestPaths.getPathCost(i), allCosts[i]), describe("cost of a k shortest path", start, end));
+		}
+	}
+
+	// On a chart, through Chart's interface
+	ChartData data;
+	string fileName = makeChart(ROAD_GRAPH, 2000, seed, data);
+	referenceLinksT reference;
+	initReference(reference, data);
+	{
+		Chart chart(fileName);
+		for(int query = 0; query < 30; query++){
+			int start = (int)(random.nextDouble() * reference.numPositions);
+			int end = (int)(random.nextDouble() * reference.numPositions);
+			std::vector<double> distances;
+			referenceDistances(reference, start, distances);
+			Vector<Path> paths = chart.getShortestPathsBetween(positionName(start), positionName(end), 8);
+			if(distances[end] == INFINITE_DISTANCE){
+				expect(paths.size() == 0, describe("k shortest paths to an unreachable end", start, end));
+				continue;
+			}
+			expect(paths.size() > 0 && sameCost(paths[0].getTotalPathCost(), distances[end]), describe("first of the k shortest paths", start, end));
+			for(int i = 0; i < paths.size(); i++){
+				expect(isPathBetween(paths[i], start, end, reference, true), describe("k shortest path links", start, end));
+				if(i > 0) expect(paths[i].getTotalPathCost() >= paths[i - 1].getTotalPathCost() - 1e-9, describe("k shortest paths order", start, end));
+				for(int j = 0; j < i; j++){
+					bool same = paths[i].lengthInLinks() == paths[j].lengthInLinks();
+					for(int l = 0; same && l < paths[i].lengthInLinks(); l++)
+						same = paths[i].getAt(l) == paths[j].getAt(l);
+					expect(!same, describe("k shortest paths are different", start, end));
+				}
+			}
+		}
+	}
+	removeChartFiles(fileName);
+	cout<<"k shortest paths : "<<(numFailed == before ? "ok" : "FAILED")<<endl;
+}
+
+/*
+* Edits a chart at random while querying it from a few starts, so that
+* their search trees stay cached and have to be repaired. Links are
+* picked by id in the reference, looked up by their ends and the link
+* Chart hands back, the cheapest between them, is the one edited.
+*/
+void checkLinkEdits(graphKindT kind, bool integerCosts, unsigned int seed){
+	int before = numFailed;
+	ChartData data;
+	string fileName = makeChart(kind, 2000, seed, data, integerCosts);
+	referenceLinksT reference;
+	initReference(reference, data);
+	{
+		Chart chart(fileName);
+		RandomStream random(seed);
+		int starts[4];
+		for(int i = 0; i < 4; i++)
+			starts[i] = (int)(random.nextDouble() * reference.numPositions);
+		for(int round = 0; round < 300; round++){
+			double action = random.nextDouble();
+			int linkId = (int)(random.nextDouble() * reference.starts.size());
+			string startName = positionName(reference.starts[linkId]);
+			string endName = positionName(reference.ends[linkId]);
+			if(action < 0.4){
+				Link * link = chart.getLinkBetween(startName, endName);
+				if(link == NULL) continue;
+				double cost = link->getCost() * random.nextDouble(0.2, 3);
+				if(integerCosts) cost = floor(cost);
+				chart.setLinkCost(link, cost);
+				reference.costs[link->getId()] = cost;
+			}else if(action < 0.5){
+				Link * link = chart.getLinkBetween(startName, endName);
+				if(link == NULL) continue;
+				chart.removeLink(link);
+				reference.removed[link->getId()] = true;
+			}else if(action < 0.6){
+				int start = (int)(random.nextDouble() * reference.numPositions);
+				int end = (int)(random.nextDouble() * reference.numPositions);
+				double cost = random.nextDouble() * 200;
+				if(integerCosts) cost = floor(cost);
+				Link * link = chart.addLinkBetween(positionName(start), positionName(end), cost);
+				expect(link->getId() == (int)reference.starts.size(), "id of an added link");
+				reference.starts.push_back(start);
+				reference.ends.push_back(end);
+				reference.costs.push_back(cost);
+				reference.removed.push_back(false);
+			}else{
+				checkQueries(chart, reference, starts[(int)(random.nextDouble() * 4)], 3, random, round % 10 == 0);
+			}
+		}
+	}
+	removeChartFiles(fileName);
+	cout<<"link edits on "<<graphKindName(kind)<<(integerCosts ? ", whole number costs" : "")
+		<<" : "<<(numFailed == before ? "ok" : "FAILED")<<endl;
+}
+
+std::vector<char> readBytes(string fileName){
+	std::vector<char> bytes;
+	FILE * file = fopen(fileName.c_str(), "rb");
+	if(file == NULL) return bytes;
+	int c;
+	while((c = fgetc(file)) != EOF)
+		bytes.push_back((char)c);
+	fclose(file);
+	return bytes;
+}
+
+void writeBytes(string fileName, const std::vector<char> &bytes){
+	FILE * file = fopen(fileName.c_str(), "wb");
+	if(file == NULL) Error("Can't write " + fileName);
+	if(!bytes.empty()) fwrite(&bytes[0], 1, bytes.size(), file);
+	fclose(file);
+}
+
+// Overwrites the int at the given byte offset of a copy of the bytes
+std::vector<char> damaged(const std::vector<char> &bytes, long offset, int value){
+	std::vector<char> copy = bytes;
+	if(offset + (long)sizeof(int) <= (long)copy.size()) memcpy(&copy[offset], &value, sizeof(int));
+	return copy;
+}
+
+void checkCompiledFiles(unsigned int seed){
+	int before = numFailed;
+	ChartData parsed;
+	string fileName = makeChart(GEOMETRIC_GRAPH, 2000, seed, parsed);
+	string binaryFileName = compiledChartName(fileName);
+
+	// Chart round trip
+	ChartData loaded;
+	loadChartData(fileName, loaded);
+	ChartData compiled;
+	expect(readCompiledChart(binaryFileName, fileName, compiled), "reading a compiled chart back");
+	bool same = compiled.numPositions() == parsed.numPositions() && compiled.linkStarts == parsed.linkStarts
+		&& compiled.linkEnds == parsed.linkEnds && compiled.linkCosts == parsed.linkCosts
+		&& compiled.imageFileName == parsed.imageFileName;
+	for(int i = 0; same && i < parsed.numPositions(); i++){
+		same = strcmp(compiled.getName(i), parsed.getName(i)) == 0 && compiled.coords[i].x == parsed.coords[i].x
+			&& compiled.coords[i].y == parsed.coords[i].y;
+	}
+	expect(same, "compiled chart holds what was parsed");
+
+	// Offsets of the sections, laid out as described in chartbinary.h
+	int numPositions = parsed.numPositions(), numLinks = parsed.numLinks();
+	long linkStartsAt = alignSection(sizeof(compiledChartHeaderT)) + alignSection(numPositions * sizeof(coordT))
+		+ alignSection(numLinks * sizeof(double)) + alignSection(numPositions * sizeof(int));
+	long edgeOffsetsAt = linkStartsAt + 2 * alignSection(numLinks * sizeof(int));
+	long edgeTargetsAt = edgeOffsetsAt + alignSection((numPositions + 1) * sizeof(int));
+	long edgeLinksAt = edgeTargetsAt + alignSection(2 * numLinks * sizeof(int));
+	std::vector<char> bytes = readBytes(binaryFileName);
+	long damages[][2] = {{linkStartsAt, numPositions}, {linkStartsAt + 4, -1}, {edgeTargetsAt, 1 << 30},
+		{edgeLinksAt, numLinks}, {edgeOffsetsAt, 1}, {edgeOffsetsAt + 4 * 10, 1 << 30}};
+	for(int i = 0; i < 6; i++){
+		writeBytes(binaryFileName, damaged(bytes, damages[i][0], (int)damages[i][1]));
+		ChartData refused;
+		expect(!readCompiledChart(binaryFileName, fileName, refused), "refusing a damaged compiled chart");
+	}
+	bytes.resize(bytes.size() / 2);
+	writeBytes(binaryFileName, bytes);
+	ChartData reparsed;
+	loadChartData(fileName, reparsed);
+	expect(reparsed.linkStarts == parsed.linkStarts && reparsed.linkCosts == parsed.linkCosts,
+		"parsing the text again when the compiled chart is cut short");
+
+	// Hierarchy round trip
+	string hierarchyName = hierarchyFileName(fileName);
+	CSRGraph graph;
+	graph.build(numPositions, parsed.linkStarts, parsed.linkEnds, parsed.linkCosts);
+	ContractionHierarchy built;
+	built.build(graph);
+	expect(built.save(hierarchyName, fileName), "saving a hierarchy");
+	std::vector<char> saved = readBytes(hierarchyName);
+	ContractionHierarchy builtAgain;
+	builtAgain.build(graph);
+	builtAgain.save(hierarchyName, fileName);
+	expect(readBytes(hierarchyName) == saved, "the same hierarchy saves to the same bytes");
+	ContractionHierarchy reloaded;
+	expect(reloaded.load(hierarchyName, fileName, graph), "loading a saved hierarchy");
+	RandomStream random(seed);
+	for(int query = 0; query < 100 && reloaded.isBuilt(); query++){
+		int start = (int)(random.nextDouble() * numPositions);
+		int end = (int)(random.nextDouble() * numPositions);
+		bool foundBuilt = built.findShortestPath(start, end);
+		bool foundLoaded = reloaded.findShortestPath(start, end);
+		expect(foundBuilt == foundLoaded && (!foundBuilt || built.getPathCost() == reloaded.getPathCost()),
+			describe("loaded hierarchy answers as built", start, end));
+	}
+
+	// A 48 byte header, rank, then the arcs at 28 bytes each, the shortcuts after the links
+	long rankAt = alignSection(48);
+	long arcsAt = rankAt + alignSection(numPositions * sizeof(int));
+	int numArcs = (saved.size() - arcsAt) / 28;
+	int lastArc = numArcs - 1;
+	expect(lastArc >= numLinks, "the hierarchy has shortcuts");
+	long arcAt = arcsAt + 28L * lastArc;
+	long hierarchyDamages[][2] = {{rankAt, rankAt + 4}, {rankAt, numPositions}, {arcAt, numPositions},
+		{arcAt + 16, -1}, {arcAt + 20, lastArc}, {arcAt + 24, lastArc + 1}, {arcAt + 20, 0}};
+	for(int i = 0; i < 7; i++){
+		std::vector<char> copy = saved;
+		if(i == 0){
+			// Two positions of the same rank
+			memcpy(&copy[hierarchyDamages[i][1]], &copy[hierarchyDamages[i][0]], sizeof(int));
+		}else{
+			copy = damaged(saved, hierarchyDamages[i][0], (int)hierarchyDamages[i][1]);
+		}
+		writeBytes(hierarchyName, copy);
+		ContractionHierarchy refused;
+		expect(!refused.load(hierarchyName, fileName, graph) && !refused.isBuilt(), "refusing a damaged hierarchy");
+	}
+	removeChartFiles(fileName);
+	cout<<"compiled files : "<<(numFailed == before ? "ok" : "FAILED")<<endl;
+}
+
+/*
+* Queries from a few starts over and over, with the tree cache off, with
+* room for one tree and with the default budget, so that trees are
+* reused, resumed and given to other starts.
+*/
+void checkTreeCacheBudgets(unsigned int seed){
+	int before = numFailed;
+	ChartData data;
+	string fileName = makeChart(ROAD_GRAPH, 2000, seed, data);
+	referenceLinksT reference;
+	initReference(reference, data);
+	long budgets[] = {0, (long)TREE_BYTES_PER_NODE * data.numPositions(), DEFAULT_TREE_CACHE_BYTES};
+	int capacities[] = {0, 1, MAX_TREE_CACHE_SIZE};
+	for(int b = 0; b < 3; b++){
+		Chart chart(fileName, NULL, budgets[b]);
+		RandomStream random(seed);
+		int starts[5];
+		for(int i = 0; i < 5; i++)
+			starts[i] = (int)(random.nextDouble() * reference.numPositions);
+		for(int query = 0; query < 40; query++)
+			checkQueries(chart, reference, starts[(int)(random.nextDouble() * 5)], 2, random, false);
+		SearchTreeCache cache(budgets[b]);
+		CSRGraph graph;
+		graph.build(data.numPositions(), data.linkStarts, data.linkEnds, data.linkCosts);
+		cache.setGraph(&graph);
+		expect(cache.getCapacity() == capacities[b], "number of trees that fit in the budget");
+	}
+	removeChartFiles(fileName);
+	cout<<"tree cache budgets : "<<(numFailed == before ? "ok" : "FAILED")<<endl;
+}
+
+// Root of the part a position is in, halving the way up as it goes
+int referenceRoot(std::vector<int> &parent, int node){
+	while(parent[node] != node){
+		parent[node] = parent[parent[node]];
+		node = parent[node];
+	}
+	return node;
+}
+
+// Kruskal's algorithm on the reference, returns the total cost of the tree and fills in its number of links
+double referenceTreeCost(const referenceLinksT &reference, int &numTreeLinks){
+	std::vector<std::pair<double, int> > byCost;
+	for(int i = 0; i < (int)reference.starts.size(); i++)
+		if(!reference.removed[i]) byCost.push_back(std::make_pair(reference.costs[i], i));
+	std::sort(byCost.begin(), byCost.end());
+	std::vector<int> parent(reference.numPositions);
+	for(int i = 0; i < reference.numPositions; i++) parent[i] = i;
+	double totalCost = 0;
+	numTreeLinks = 0;
+	for(int i = 0; i < (int)byCost.size(); i++){
+		int linkId = byCost[i].second;
+		int startRoot = referenceRoot(parent, reference.starts[linkId]);
+		int endRoot = referenceRoot(parent, reference.ends[linkId]);
+		if(startRoot == endRoot) continue;
+		parent[startRoot] = endRoot;
+		totalCost += byCost[i].first;
+		numTreeLinks++;
+	}
+	return totalCost;
+}
+
+/*
+* Returns true if none of the links is removed and every one of them
+* joins two parts the ones before it left apart, so they close no
+* cycle. Fills in their total cost.
+*/
+bool isForest(Vector<Link* > &treeLinks, const referenceLinksT &reference, double &totalCost){
+	std::vector<int> parent(reference.numPositions);
+	for(int i = 0; i < reference.numPositions; i++) parent[i] = i;
+	totalCost = 0;
+	for(int i = 0; i < treeLinks.size(); i++){
+		int linkId = treeLinks[i]->getId();
+		if(linkId >= (int)reference.removed.size() || reference.removed[linkId]) return false;
+		int startRoot = referenceRoot(parent, reference.starts[linkId]);
+		int endRoot = referenceRoot(parent, reference.ends[linkId]);
+		if(startRoot == endRoot) return false;
+		parent[startRoot] = endRoot;
+		totalCost += reference.costs[linkId];
+	}
+	return true;
+}
+
+/*
+* Checks a spanning tree mode of Chart against Kruskal's algorithm on
+* the reference, on the charts as made up and again after removing
+* links, so that they fall apart, and adding parallel links and links
+* from a position to itself. A forest with as many links as the
+* reference tree joins every position the reference tree joins.
+*/
+void checkSpanningTrees(spanningTreeModeT mode, string modeName, unsigned int seed){
+	int before = numFailed;
+	graphKindT kinds[] = {GRID_GRAPH, GEOMETRIC_GRAPH, ROAD_GRAPH};
+	for(int k = 0; k < 3; k++){
+		ChartData data;
+		string fileName = makeChart(kinds[k], 3000, seed + k, data);
+		referenceLinksT reference;
+		initReference(reference, data);
+		{
+			Chart chart(fileName);
+			RandomStream random(seed + k);
+			for(int round = 0; round < 2; round++){
+				Vector<Link* > treeLinks = chart.getMinimalSpanningTree(mode);
+				int numTreeLinks;
+				double referenceCost = referenceTreeCost(reference, numTreeLinks);
+				double totalCost;
+				string where = " on " + graphKindName(kinds[k]) + (round == 0 ? "" : ", edited");
+				expect(isForest(treeLinks, reference, totalCost), modeName + " tree links close no cycle" + where);
+				expect(treeLinks.size() == numTreeLinks, modeName + " tree joins every position" + where);
+				expect(sameCost(totalCost, referenceCost), modeName + " tree cost" + where);
+				for(int i = 0; i < 300; i++){
+					int linkId = (int)(random.nextDouble() * reference.starts.size());
+					Link * link = chart.getLinkBetween(positionName(reference.starts[linkId]), positionName(reference.ends[linkId]));
+					if(link == NULL) continue;
+					chart.removeLink(link);
+					reference.removed[link->getId()] = true;
+				}
+				for(int i = 0; i < 100; i++){
+					int linkId = (int)(random.nextDouble() * data.numLinks());
+					int start = reference.starts[linkId];
+					int end = (i % 10 == 0) ? start : reference.ends[linkId];
+					double cost = random.nextDouble() * 100;
+					Link * link = chart.addLinkBetween(positionName(start), positionName(end), cost);
+					reference.starts.push_back(start);
+					reference.ends.push_back(end);
+					reference.costs.push_back(link->getCost());
+					reference.removed.push_back(false);
+				}
+			}
+		}
+		removeChartFiles(fileName);
+	}
+	cout<<modeName<<" spanning trees : "<<(numFailed == before ? "ok" : "FAILED")<<endl;
+}
+
+/*
+* Checks getDistanceMatrix against the reference Dijkstra from every
+* source, on charts that fall apart in pieces, with sources repeated
+* and shared with the targets, and again after link edits.
+*/
+void checkDistanceMatrix(unsigned int seed){
+	int before = numFailed;
+	graphKindT kinds[] = {GEOMETRIC_GRAPH, ROAD_GRAPH};
+	for(int k = 0; k < 2; k++){
+		ChartData data;
+		string fileName = makeChart(kinds[k], 3000, seed + k, data);
+		referenceLinksT reference;
+		initReference(reference, data);
+		{
+			Chart chart(fileName);
+			RandomStream random(seed + k);
+			for(int round = 0; round < 2; round++){
+				Vector<string> sourceNames, targetNames;
+				std::vector<int> sources, targets;
+				for(int i = 0; i < 20; i++)
+					sources.push_back((i % 7 == 6) ? sources[i - 1] : (int)(random.nextDouble() * reference.numPositions));
+				for(int i = 0; i < 30; i++)
+					targets.push_back((i < 5) ? sources[i] : (int)(random.nextDouble() * reference.numPositions));
+				for(int i = 0; i < (int)sources.size(); i++) sourceNames.add(positionName(sources[i]));
+				for(int i = 0; i < (int)targets.size(); i++) targetNames.add(positionName(targets[i]));
+				Grid<double> matrix = chart.getDistanceMatrix(sourceNames, targetNames);
+				expect(matrix.numRows() == (int)sources.size() && matrix.numCols() == (int)targets.size(), "size of the distance matrix");
+				for(int i = 0; i < matrix.numRows(); i++){
+					std::vector<double> distances;
+					referenceDistances(reference, sources[i], distances);
+					for(int j = 0; j < matrix.numCols(); j++)
+						expect(sameCost(matrix.getAt(i, j), distances[targets[j]]), describe("distance matrix entry", sources[i], targets[j]));
+				}
+				for(int i = 0; i < 200; i++){
+					int linkId = (int)(random.nextDouble() * reference.starts.size());
+					Link * link = chart.getLinkBetween(positionName(reference.starts[linkId]), positionName(reference.ends[linkId]));
+					if(link == NULL) continue;
+					if(i % 2 == 0){
+						chart.removeLink(link);
+						reference.removed[link->getId()] = true;
+					}else{
+						double cost = link->getCost() * random.nextDouble(0.2, 3);
+						chart.setLinkCost(link, cost);
+						reference.costs[link->getId()] = cost;
+					}
+				}
+			}
+		}
+		removeChartFiles(fileName);
+	}
+	cout<<"distance matrix : "<<(numFailed == before ? "ok" : "FAILED")<<endl;
+}
+
+// Fewest links from start to every position by breadth first search, -1 where there is no way
+void referenceHops(const referenceLinksT &reference, int start, std::vector<int> &hops){
+	std::vector<std::vector<int> > neighbors(reference.numPositions);
+	for(int i = 0; i < (int)reference.starts.size(); i++){
+		if(reference.removed[i]) continue;
+		neighbors[reference.starts[i]].push_back(reference.ends[i]);
+		neighbors[reference.ends[i]].push_back(reference.starts[i]);
+	}
+	hops.assign(reference.numPositions, -1);
+	hops[start] = 0;
+	std::queue<int> queue;
+	queue.push(start);
+	while(!queue.empty()){
+		int node = queue.front();
+		queue.pop();
+		for(int i = 0; i < (int)neighbors[node].size(); i++){
+			if(hops[neighbors[node][i]] != -1) continue;
+			hops[neighbors[node][i]] = hops[node] + 1;
+			queue.push(neighbors[node][i]);
+		}
+	}
+}
+
+/*
+* Checks searchPathBetween with no budget and with each budget alone
+* against Dijkstra and breadth first search on the reference:
+* the status says whether the end was reached and which budget ran out,
+* a path is only handed back when it was reached and then keeps to the
+* budget. With a budget of n settled positions the end must be reached
+* if at most n positions are as close as it, and must not be if n are
+* closer.
+*/
+void checkSearchLimits(unsigned int seed){
+	int before = numFailed;
+	graphKindT kinds[] = {GEOMETRIC_GRAPH, ROAD_GRAPH};
+	for(int k = 0; k < 2; k++){
+		ChartData data;
+		string fileName = makeChart(kinds[k], 2000, seed + k, data);
+		referenceLinksT reference;
+		initReference(reference, data);
+		{
+			Chart chart(fileName);
+			RandomStream random(seed + k);
+			for(int query = 0; query < 30; query++){
+				int start = (int)(random.nextDouble() * reference.numPositions);
+				std::vector<double> distances;
+				std::vector<int> hops;
+				referenceDistances(reference, start, distances);
+				referenceHops(reference, start, hops);
+				for(int i = 0; i < 5; i++){
+					int end = (int)(random.nextDouble() * reference.numPositions);
+					string startName = positionName(start), endName = positionName(end);
+					bool reachable = distances[end] != INFINITE_DISTANCE;
+
+					pathSearchT result = chart.searchPathBetween(startName, endName);
+					expect(result.status == (reachable ? PATH_FOUND : UNREACHABLE), describe("status without budgets", start, end));
+					if(result.status == PATH_FOUND){
+						expect(sameCost(result.path.getTotalPathCost(), distances[end]), describe("path cost without budgets", start, end));
+						expect(isPathBetween(result.path, start, end, reference, false), describe("path links without budgets", start, end));
+					}else{
+						expect(result.path.lengthInLinks() == 0, describe("no path handed back without budgets", start, end));
+					}
+
+					searchLimitsT limits = NO_SEARCH_LIMITS;
+					limits.maxCost = reachable ? distances[end] * random.nextDouble(0.5, 1.5) : random.nextDouble() * 200;
+					result = chart.searchPathBetween(startName, endName, limits);
+					if(distances[end] <= limits.maxCost){
+						expect(result.status == PATH_FOUND, describe("status within the cost budget", start, end));
+						expect(sameCost(result.path.getTotalPathCost(), distances[end]), describe("path cost within the cost budget", start, end));
+					}else{
+						bool cut = result.status == COST_LIMIT_REACHED || (!reachable && result.status == UNREACHABLE);
+						expect(cut, describe("status past the cost budget", start, end));
+						expect(result.path.lengthInLinks() == 0, describe("no path handed back past the cost budget", start, end));
+					}
+
+					limits = NO_SEARCH_LIMITS;
+					limits.maxHops = reachable ? (int)(hops[end] * random.nextDouble(0.5, 1.5)) : (int)(random.nextDouble() * 50);
+					result = chart.searchPathBetween(startName, endName, limits);
+					if(result.status == PATH_FOUND){
+						expect(result.path.lengthInLinks() <= limits.maxHops, describe("path links within the link budget", start, end));
+						expect(isPathBetween(result.path, start, end, reference, false), describe("path within the link budget", start, end));
+						expect(result.path.getTotalPathCost() >= distances[end] * (1 - 1e-9), describe("path cost within the link budget", start, end));
+					}else{
+						expect(result.path.lengthInLinks() == 0, describe("no path handed back past the link budget", start, end));
+					}
+					if(reachable && hops[end] > limits.maxHops)
+						expect(result.status == HOP_LIMIT_REACHED, describe("status past the link budget", start, end));
+					if(!reachable)
+						expect(result.status == UNREACHABLE || result.status == HOP_LIMIT_REACHED, describe("status of an unreachable end", start, end));
+
+					limits = NO_SEARCH_LIMITS;
+					limits.maxSettled = (int)(random.nextDouble() * reference.numPositions);
+					result = chart.searchPathBetween(startName, endName, limits);
+					int numCloser = 0, numAsClose = 0;
+					for(int pos = 0; pos < reference.numPositions; pos++){
+						if(distances[pos] < distances[end]) numCloser++;
+						if(distances[pos] <= distances[end]) numAsClose++;
+					}
+					expect(result.numSettled <= limits.maxSettled, describe("positions settled within the budget", start, end));
+					if(result.status == PATH_FOUND)
+						expect(sameCost(result.path.getTotalPathCost(), distances[end]), describe("path cost within the settle budget", start, end));
+					if(reachable && numAsClose <= limits.maxSettled)
+						expect(result.status == PATH_FOUND, describe("status within the settle budget", start, end));
+					if(numCloser >= limits.maxSettled)
+						expect(result.status == SETTLE_LIMIT_REACHED, describe("status past the settle budget", start, end));
+				}
+			}
+		}
+		removeChartFiles(fileName);
+	}
+	cout<<"search budgets : "<<(numFailed == before ? "ok" : "FAILED")<<endl;
+}
+
+/*
+* Checks getReachableWithin against the reference Dijkstra: it hands
+* back every position at most the budget away and no other, nearest
+* first with the right costs, and each link that can be crossed from
+* either end within the budget once. With whole number costs and
+* budgets many positions sit right on the budget.
+*/
+void checkReachableWithin(graphKindT kind, bool integerCosts, unsigned int seed){
+	int before = numFailed;
+	ChartData data;
+	string fileName = makeChart(kind, 2000, seed, data, integerCosts);
+	referenceLinksT reference;
+	initReference(reference, data);
+	{
+		Chart chart(fileName);
+		RandomStream random(seed);
+		for(int query = 0; query < 40; query++){
+			int start = (int)(random.nextDouble() * reference.numPositions);
+			int end = (int)(random.nextDouble() * reference.numPositions);
+			std::vector<double> distances;
+			referenceDistances(reference, start, distances);
+			double budget = (distances[end] == INFINITE_DISTANCE) ? 100 : distances[end] * random.nextDouble(0.3, 1.2);
+			if(integerCosts) budget = floor(budget);
+			if(query == 0) budget = -1;
+			string where = describe("reachable", start, end);
+			reachableT area = chart.getReachableWithin(positionName(start), budget, query % 2 == 0);
+
+			std::vector<bool> listed(reference.numPositions, false);
+			bool inOrder = true, costsRight = true, listedOnce = true;
+			expect(area.positions.size() == area.costs.size(), where + ", a cost for every position");
+			for(int i = 0; i < area.positions.size() && i < area.costs.size(); i++){
+				int posId = area.positions[i]->getId();
+				if(listed[posId]) listedOnce = false;
+				listed[posId] = true;
+				if(!sameCost(area.costs[i], distances[posId])) costsRight = false;
+				if(i > 0 && area.costs[i] < area.costs[i - 1]) inOrder = false;
+			}
+			int numWithin = 0;
+			for(int pos = 0; pos < reference.numPositions; pos++)
+				if(distances[pos] <= budget) numWithin++;
+			expect(listedOnce && area.positions.size() == numWithin, where + " positions");
+			expect(costsRight, where + " costs");
+			expect(inOrder, where + " nearest first");
+
+			std::vector<int> timesListed(reference.starts.size(), 0);
+			for(int i = 0; i < area.links.size(); i++)
+				timesListed[area.links[i]->getId()]++;
+			bool linksRight = true;
+			for(int i = 0; i < (int)reference.starts.size(); i++){
+				bool crossed = reference.starts[i] != reference.ends[i]
+					&& (distances[reference.starts[i]] + reference.costs[i] <= budget
+					|| distances[reference.ends[i]] + reference.costs[i] <= budget);
+				if(timesListed[i] != ((crossed && query % 2 == 0) ? 1 : 0)) linksRight = false;
+			}
+			expect(linksRight, where + " links");
+		}
+	}
+	removeChartFiles(fileName);
+	cout<<"reachable within on "<<graphKindName(kind)<<(integerCosts ? ", whole number costs" : "")
+		<<" : "<<(numFailed == before ? "ok" : "FAILED")<<endl;
+}
+
+double squaredDistanceBetween(coordT one, coordT two){
+	return (one.x - two.x) * (one.x - two.x) + (one.y - two.y) * (one.y - two.y);
+}
+
+/*
+* Asks a SpatialIndex for the nearest point and the points within a
+* radius of random places, inside the points and far off, and compares
+* with looking at every point.
+*/
+void checkSpatialQueries(SpatialIndex &index, const std::vector<coordT> &points, RandomStream &random, string where){
+	double minX = 0, maxX = 1, minY = 0, maxY = 1;
+	for(int i = 0; i < (int)points.size(); i++){
+		if(i == 0 || points[i].x < minX) minX = points[i].x;
+		if(i == 0 || points[i].x > maxX) maxX = points[i].x;
+		if(i == 0 || points[i].y < minY) minY = points[i].y;
+		if(i == 0 || points[i].y > maxY) maxY = points[i].y;
+	}
+	double width = std::max(maxX - minX, 1.0), height = std::max(maxY - minY, 1.0);
+	for(int query = 0; query < 200; query++){
+		coordT place;
+		place.x = random.nextDouble(minX - width, maxX + width);
+		place.y = random.nextDouble(minY - height, maxY + height);
+		if(query % 2 == 0 && !points.empty()) place = points[(int)(random.nextDouble() * points.size())];
+		double nearest = INFINITE_DISTANCE;
+		for(int i = 0; i < (int)points.size(); i++)
+			nearest = std::min(nearest, squaredDistanceBetween(place, points[i]));
+
+		int id = index.findNearest(place);
+		if(points.empty()) expect(id == -1, "nearest point of an empty index" + where);
+		else expect(id >= 0 && id < (int)points.size() && squaredDistanceBetween(place, points[id]) == nearest, "nearest point" + where);
+
+		double maxDistance = random.nextDouble() * width / 4;
+		id = index.findNearest(place, maxDistance);
+		if(nearest > maxDistance * maxDistance) expect(id == -1, "no point within the distance" + where);
+		else expect(id >= 0 && id < (int)points.size() && squaredDistanceBetween(place, points[id]) == nearest, "nearest point within the distance" + where);
+
+		double radius = random.nextDouble() * width / 4;
+		std::vector<int> ids, within;
+		index.findWithin(place, radius, ids);
+		for(int i = 0; i < (int)points.size(); i++)
+			if(squaredDistanceBetween(place, points[i]) <= radius * radius) within.push_back(i);
+		std::sort(ids.begin(), ids.end());
+		expect(ids == within, "points within the radius" + where);
+	}
+}
+
+/*
+* Checks SpatialIndex on points spread evenly, bunched up, repeated,
+* on a line, a single point and none, and the Chart functions built on
+* it against looking at every position.
+*/
+void checkSpatialIndex(unsigned int seed){
+	int before = numFailed;
+	RandomStream random(seed);
+	for(int layout = 0; layout < 6; layout++){
+		std::vector<coordT> points;
+		int numPoints = (layout == 4) ? 1 : (layout == 5) ? 0 : 3000;
+		for(int i = 0; i < numPoints; i++){
+			coordT point;
+			point.x = random.nextDouble(-500, 500);
+			point.y = random.nextDouble(-500, 500);
+			if(layout == 1 && i % 10 != 0){
+				point.x = points[i - i % 10].x + random.nextDouble(-0.01, 0.01);
+				point.y = points[i - i % 10].y + random.nextDouble(-0.01, 0.01);
+			}
+			if(layout == 2 && i >= 100) point = points[i % 100];
+			if(layout == 3) point.y = 7;
+			points.push_back(point);
+		}
+		SpatialIndex index;
+		index.build(points);
+		char where[32];
+		sprintf(where, " in layout %d", layout);
+		checkSpatialQueries(index, points, random, where);
+	}
+
+	ChartData data;
+	string fileName = makeChart(GEOMETRIC_GRAPH, 2000, seed, data);
+	{
+		Chart chart(fileName);
+		double span = 0;
+		for(int i = 0; i < data.numPositions(); i++)
+			span = std::max(span, std::max(fabs(data.coords[i].x), fabs(data.coords[i].y)));
+		for(int query = 0; query < 100; query++){
+			coordT place;
+			place.x = random.nextDouble(-span, 2 * span);
+			place.y = random.nextDouble(-span, 2 * span);
+			double nearest = INFINITE_DISTANCE;
+			for(int i = 0; i < data.numPositions(); i++)
+				nearest = std::min(nearest, squaredDistanceBetween(place, data.coords[i]));
+			string name = chart.getNearestPositionName(place);
+			int posId = data.names.find(name);
+			expect(posId != -1 && squaredDistanceBetween(place, data.coords[posId]) == nearest, "nearest position name");
+			double radius = random.nextDouble() * span / 4;
+			Vector<string> names = chart.getPositionNamesWithin(place, radius);
+			int numWithin = 0;
+			bool allWithin = true;
+			for(int i = 0; i < data.numPositions(); i++)
+				if(squaredDistanceBetween(place, data.coords[i]) <= radius * radius) numWithin++;
+			for(int i = 0; i < names.size(); i++){
+				posId = data.names.find(names[i]);
+				if(posId == -1 || squaredDistanceBetween(place, data.coords[posId]) > radius * radius) allWithin = false;
+			}
+			expect(allWithin && names.size() == numWithin, "position names within the radius");
+		}
+	}
+	removeChartFiles(fileName);
+	cout<<"spatial index : "<<(numFailed == before ? "ok" : "FAILED")<<endl;
+}
+
+/*
+* Runs the parser on the file in a selfcheck of its own, since Error
+* ends the program, and returns what that printed.
+*/
+string parseInOwnProcess(string program, string fileName){
+	string outputName = "selfcheck_parse.out";
+	string command = "\"" + program + "\" -parse " + fileName + " > " + outputName + " 2>&1";
+#ifdef _WIN32
+	// cmd.exe takes the outermost quotes off the command line
+	command = "\"" + command + "\"";
+#endif
+	system(command.c_str());
+	std::vector<char> bytes = readBytes(outputName);
+	remove(outputName.c_str());
+	return string(bytes.begin(), bytes.end());
+}
+
+/*
+* Checks that a file in the data format, with blank lines, tabs, \r\n
+* line ends and no line end at the very end, reads back what it holds,
+* and that malformed files are reported with the right line number and
+* message.
+*/
+void checkChartParser(string program){
+	int before = numFailed;
+	const char * numbers[] = {"0", "12", "-3.25", "0.1", ".5", "1e3", "-2.5E-3", "123456789012345678", "3.14159265358979323846"};
+	string text = "map.bmp\r\n\r\nNODES\r\n";
+	for(int i = 0; i < 9; i++){
+		text += positionName(i) + "\t" + numbers[i] + "  " + numbers[8 - i] + "\r\n";
+		if(i % 3 == 0) text += " \t\r\n";
+	}
+	text += "ARCS\n";
+	// Link costs leave the minus signs out
+	for(int i = 0; i < 9; i++)
+		text += positionName(i) + " " + positionName((i * 4) % 9) + " " + (numbers[i] + (numbers[i][0] == '-')) + ((i < 8) ? "\n" : "");
+	ChartData data;
+	ChartParser parser;
+	parser.parseText(text.data(), text.size(), "selfcheck_parse.txt", data);
+	expect(data.imageFileName == "map.bmp", "image file name read");
+	expect(data.numPositions() == 9 && data.numLinks() == 9, "number of positions and links read");
+	for(int i = 0; i < data.numPositions() && i < 9; i++){
+		expect(data.names.find(positionName(i)) == i, "position name read");
+		expect(data.coords[i].x == strtod(numbers[i], NULL) && data.coords[i].y == strtod(numbers[8 - i], NULL), "position coordinates read");
+	}
+	for(int i = 0; i < data.numLinks() && i < 9; i++){
+		expect(data.linkStarts[i] == i && data.linkEnds[i] == (i * 4) % 9, "link ends read");
+		expect(data.linkCosts[i] == strtod(numbers[i] + (numbers[i][0] == '-'), NULL), "link cost read");
+	}
+
+	// Files, the line of the error and what the message says
+	struct badFileT{
+		const char * text;
+		int line;
+		const char * message;
+	} badFiles[] = {
+		{"", 0, "the file is empty"},
+		{"map.bmp extra\n", 1, "expected the name of the image file"},
+		{"map.bmp\nNODE\n", 2, "expected NODES"},
+		{"map.bmp\n\nNODES\na 1 2\n", 4, "reached the end of the file looking for ARCS"},
+		{"map.bmp\nNODES\na 1\n", 3, "expected a position as: name x y"},
+		{"map.bmp\r\nNODES\r\na 1 2\r\n\r\na 3 4\r\n", 5, "position a is defined twice"},
+		{"map.bmp\nNODES\na 1 2 3\n", 3, "too many fields"},
+		{"map.bmp\nNODES\na 1 x\n", 3, "expected a number but found x"},
+		{"map.bmp\nNODES\na 1.5.2 2\n", 3, "expected a number but found 1.5.2"},
+		{"map.bmp\nNODES\na 1e5x 2\n", 3, "expected a number but found 1e5x"},
+		{"map.bmp\nNODES\na 1 1111111111111111111111111111111111111111111111111111111111111111111111\n", 3, "number too long"},
+		{"map.bmp\nNODES\na 1 2\nb 3 4\nARCS\na b\n", 6, "expected a link as: startName endName cost"},
+		{"map.bmp\nNODES\na 1 2\nb 3 4\nARCS\na b 1\na c 5\n", 7, "no position named c"},
+		{"map.bmp\nNODES\na 1 2\nb 3 4\nARCS\n\ta\tb\t-1", 6, "link cost can't be negative: -1"}
+	};
+	string fileName = "selfcheck_parse.txt";
+	for(int i = 0; i < (int)(sizeof(badFiles) / sizeof(badFiles[0])); i++){
+		string badText = badFiles[i].text;
+		writeBytes(fileName, std::vector<char>(badText.begin(), badText.end()));
+		char line[16];
+		sprintf(line, "%d", badFiles[i].line);
+		string expected = fileName + ", line " + line + ": " + badFiles[i].message;
+		string output = parseInOwnProcess(program, fileName);
+		expect(output.find(expected) != string::npos, "parser error \"" + expected + "\", got \"" + output + "\"");
+	}
+	remove(fileName.c_str());
+	string output = parseInOwnProcess(program, fileName);
+	expect(output.find("Can't open data file " + fileName) != string::npos, "parser error for a missing file");
+	cout<<"chart parser : "<<(numFailed == before ? "ok" : "FAILED")<<endl;
+}
+
+/*
+* Checks NameTable on names that are prefixes of one another, differ in
+* one character, are empty or hold a '\0', while it grows, and once the
+* names are handed to another table with assign and swapped back.
+*/
+void checkNameTable(){
+	int before = numFailed;
+	std::vector<string> names;
+	names.push_back("");
+	names.push_back(string("a\0b", 3));
+	names.push_back(string("a\0", 2));
+	for(int i = 0; i < 3000; i++){
+		names.push_back(positionName(i));
+		names.push_back(positionName(i) + "x");
+	}
+	names.push_back(string(300, 'n'));
+	names.push_back(string(299, 'n') + "m");
+	NameTable table;
+	bool idsInOrder = true;
+	for(int i = 0; i < (int)names.size(); i++)
+		if(table.add(names[i].data(), names[i].size()) != i) idsInOrder = false;
+	expect(idsInOrder, "ids of the added names");
+
+	for(int round = 0; round < 2; round++){
+		string where = (round == 0) ? "" : ", assigned";
+		expect(table.size() == (int)names.size(), "number of names" + where);
+		bool allFound = true, allNamed = true;
+		for(int i = 0; i < (int)names.size(); i++){
+			if(table.find(names[i]) != i || table.find(names[i].data(), names[i].size()) != i) allFound = false;
+			if(memcmp(table.getName(i), names[i].data(), names[i].size()) != 0 || table.getName(i)[names[i].size()] != '\0') allNamed = false;
+		}
+		expect(allFound, "every name found" + where);
+		expect(allNamed, "every name handed back" + where);
+		expect(table.find("a", 1) == -1 && table.find(string("a\0bc", 4)) == -1, "names holding a '\\0' told from their prefixes" + where);
+		expect(table.find("p3000") == -1 && table.find("p") == -1 && table.find("p12y") == -1, "missing names" + where);
+		expect(table.find(string(301, 'n')) == -1 && table.find(string(299, 'n')) == -1, "long missing names" + where);
+
+		std::vector<char> chars(table.getChars());
+		std::vector<int> offsets(table.getOffsets());
+		NameTable other;
+		other.assign(chars, offsets);
+		expect(chars.empty() && offsets.empty(), "assign takes the names over" + where);
+		table = NameTable();
+		table.swap(other);
+		expect(other.size() == 0, "swap hands the names over" + where);
+	}
+	cout<<"name table : "<<(numFailed == before ? "ok" : "FAILED")<<endl;
+}
+
+int main(int argc, char * argv[]){
+	unsigned int seed = 1;
+	for(int i = 1; i < argc; i++){
+		string arg = argv[i];
+		if(arg == "-s" && i + 1 < argc){
+			seed = atoi(argv[++i]);
+		}else if(arg == "-parse" && i + 1 < argc){
+			// Only for checkChartParser, reports a malformed file through Error
+			ChartData data;
+			ChartParser parser;
+			parser.parseFile(argv[i + 1], data);
+			return 0;
+		}else{
+			cout<<"Usage : selfcheck [-s seed]"<<endl;
+			return 1;
+		}
+	}
+	checkSearchModes(seed);
+	checkSearchLimits(seed);
+	checkReachableWithin(GEOMETRIC_GRAPH, false, seed);
+	checkReachableWithin(GRID_GRAPH, true, seed);
+	checkSpatialIndex(seed);
+	checkChartParser(argv[0]);
+	checkNameTable();
+	checkKShortestPaths(seed);
+	checkLinkEdits(ROAD_GRAPH, false, seed);
+	checkLinkEdits(GRID_GRAPH, true, seed);
+	checkTreeCacheBudgets(seed);
+	checkSpanningTrees(KRUSKAL_TREE, "kruskal", seed);
+	checkSpanningTrees(BORUVKA_TREE, "boruvka", seed);
+	checkSpanningTrees(FILTER_KRUSKAL_TREE, "filter kruskal", seed);
+	checkDistanceMatrix(seed);
+	checkCompiledFiles(seed);
+	cout<<numFailed<<" of "<<numChecks<<" checks failed"<<endl;
+	return numFailed == 0 ? 0 : 1;
+}
@@ -0,0 +1,308 @@
+/*
+* File : spanningtree.h
+* ----------------------
+* Minimal spanning tree algorithms that run on a CSRGraph. They report
+* the tree as the list of ids of the links that make it up, turning
+* those back into Links (and drawing them) is left to the Chart.
+*
+* Every algorithm here finds the same tree on every run. When several
+* trees are minimal they may pick different ones, but of the same total
+* cost.
+*/
+
+#ifndef SPANNING_TREE_H
+#define SPANNING_TREE_H
+
+#include <vector>
+#include <algorithm>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "csrgraph.h"
+#include "indexedheap.h"
+#include "disjointset.h"
+#include "searchstats.h"
+
+/*
+* Function : kruskalSpanningTree
+* Usage    : kruskalSpanningTree(graph, treeLinkIds, &stats);
+* -----------------------------------------------------------
+* Finds the minimal spanning tree (a forest if the graph is not
+* connected) by kruskal's algorithm: links are taken cheapest first
+* and kept whenever they join two different parts of the forest grown
+* so far. The ids of the kept links are stored in treeLinkIds in the
+* order they were accepted. If stats is given, the links looked at and
+* the heap traffic are added to it (see searchstats.h).
+*/
+void kruskalSpanningTree(const CSRGraph &graph, std::vector<int> &treeLinkIds, searchStatsT * stats = NULL){
+	(void)stats;    // only counted into when compiled with COLLECT_SEARCH_STATS
+	int numLinks = graph.numLinks();
+	IndexedHeap<double> linksByCost(numLinks);
+	for(int linkId = 0; linkId < numLinks; linkId++)
+		if(!graph.isLinkRemoved(linkId)) linksByCost.enqueue(linkId, graph.getLinkCost(linkId));
+
+	// A spanning tree of n positions has n-1 links, no need to look further
+	DisjointSet forest(graph.numNodes());
+	int linksNeeded = graph.numNodes() - 1;
+	treeLinkIds.clear();
+	while(!linksByCost.isEmpty() && linksNeeded > 0){
+		int linkId = linksByCost.dequeueMin();
+		COUNT_STAT(if(stats != NULL) stats->edgesRelaxed++);
+		if(forest.unite(graph.getLinkStart(linkId), graph.getLinkEnd(linkId))){
+			treeLinkIds.push_back(linkId);
+			linksNeeded--;
+		}
+	}
+	COUNT_STAT(if(stats != NULL) addStats(*stats, linksByCost.getStats()));
+}
+
+// True if link1 comes before link2 in the order the spanning trees take links in
+bool isCheaperLink(const CSRGraph &graph, int linkId1, int linkId2){
+	double cost1 = graph.getLinkCost(linkId1), cost2 = graph.getLinkCost(linkId2);
+	return cost1 < cost2 || (cost1 == cost2 && linkId1 < linkId2);
+}
+
+/*
+* Function : boruvkaSpanningTree
+* Usage    : boruvkaSpanningTree(graph, treeLinkIds, &stats);
+* -----------------------------------------------------------
+* Finds the same tree as kruskalSpanningTree by boruvka's algorithm,
+* which suits many cores better: every round each part of the forest
+* picks the cheapest link leaving it, all of those links are added at
+* once and the parts they join are merged. The number of parts at least
+* halves every round, so there are at most log2(n) of them. The ids of
+* the kept links are stored in treeLinkIds round by round.
+*
+* Implementation notes
+* ---------------------
+* Every node looks through its own edges for the cheapest one leaving
+* its part, which is where nearly all the work is, so the nodes are
+* split between threads. The per part minimum, the merging and the
+* renaming of the parts only touch one entry per part and are done
+* serially, except for handing every node its new part which is
+* parallel again. Ordering links by cost and then id makes the cheapest
+* link of every part unique, so the links picked in a round can't close
+* a cycle (two parts picking the same link is caught by the DisjointSet).
+*/
+void boruvkaSpanningTree(const CSRGraph &graph, std::vector<int> &treeLinkIds, searchStatsT * stats = NULL){
+	(void)stats;    // only counted into when compiled with COLLECT_SEARCH_STATS
+	int numNodes = graph.numNodes();
+	std::vector<int> partOf(numNodes);     // the part each node is in, named by a node of it
+	std::vector<int> parts(numNodes);      // the names of the parts left
+	std::vector<int> cheapestOfNode(numNodes);
+	std::vector<int> cheapestOfPart(numNodes, -1);
+	for(int node = 0; node < numNodes; node++){
+		partOf[node] = node;
+		parts[node] = node;
+	}
+	DisjointSet forest(numNodes);
+	treeLinkIds.clear();
+	long long edgesLooked = 0;
+
+	while(true){
+		#ifdef _OPENMP
+		#pragma omp parallel for schedule(dynamic, 1024) reduction(+:edgesLooked)
+		#endif
+		for(int node = 0; node < numNodes; node++){
+			int cheapest = -1;
+			for(int edge = graph.firstEdge(node); edge < graph.endEdge(node); edge++){
+				edgesLooked++;
+				int linkId = graph.getLinkId(edge);
+				if(partOf[graph.getTarget(edge)] == partOf[node]) continue;
+				if(cheapest == -1 || isCheaperLink(graph, linkId, cheapest)) cheapest = linkId;
+			}
+			cheapestOfNode[node] = cheapest;
+		}
+
+		for(int node = 0; node < numNodes; node++){
+			int linkId = cheapestOfNode[node];
+			if(linkId == -1) continue;
+			int &best = cheapestOfPart[partOf[node]];
+			if(best == -1 || isCheaperLink(graph, linkId, best)) best = linkId;
+		}
+
+		bool merged = false;
+		for(int i = 0; i < (int)parts.size(); i++){
+			int linkId = cheapestOfPart[parts[i]];
+			if(linkId == -1) continue;
+			if(forest.unite(graph.getLinkStart(linkId), graph.getLinkEnd(linkId))){
+				treeLinkIds.push_back(linkId);
+				merged = true;
+			}
+		}
+		if(!merged) break;
+
+		// Parts are renamed after the root of their set, the old name indexes the new one
+		std::vector<int> partsLeft;
+		for(int i = 0; i < (int)parts.size(); i++){
+			int root = forest.find(parts[i]);
+			cheapestOfPart[parts[i]] = root;
+			if(root == parts[i]) partsLeft.push_back(root);
+		}
+		#ifdef _OPENMP
+		#pragma omp parallel for schedule(static)
+		#endif
+		for(int node = 0; node < numNodes; node++)
+			partOf[node] = cheapestOfPart[partOf[node]];
+		for(int i = 0; i < (int)parts.size(); i++)
+			cheapestOfPart[parts[i]] = -1;
+		parts.swap(partsLeft);
+	}
+	COUNT_STAT(if(stats != NULL) stats->edgesRelaxed += edgesLooked);
+}
+
+/*
+* A link copied out of the graph for filterKruskalSpanningTree, links
+* sort by cost and then by id.
+*/
+struct linkEntryT{
+	double cost;
+	int start;
+	int end;
+	int linkId;
+};
+
+bool operator<(const linkEntryT &entry1, const linkEntryT &entry2){
+	return entry1.cost < entry2.cost || (entry1.cost == entry2.cost && entry1.linkId < entry2.linkId);
+}
+
+/*
+* Ranges of at most this many links, or of no more than the tree still
+* needs, are sorted outright by filterKruskalSpanningTree rather than
+* split again.
+* Sorts of at least PARALLEL_SORT_MIN links are split between threads.
+*/
+const int FILTER_KRUSKAL_BASE = 1024;
+const int PARALLEL_SORT_MIN = 32768;
+
+/*
+* Function : sortLinkEntries
+* Usage    : sortLinkEntries(entries.begin(), entries.end());
+* -----------------------------------------------------------
+* Sorts the links cheapest first. Long ranges are cut in a power of two
+* number of chunks which are sorted by different threads and then
+* merged pairwise, the merges of each level in parallel too.
+*/
+void sortLinkEntries(std::vector<linkEntryT>::iterator begin, std::vector<linkEntryT>::iterator end){
+	int count = end - begin;
+	int numChunks = 1;
+#ifdef _OPENMP
+	if(count >= PARALLEL_SORT_MIN)
+		while(numChunks < omp_get_max_threads()) numChunks *= 2;
+#endif
+	if(numChunks == 1){
+		std::sort(begin, end);
+		return;
+	}
+	std::vector<int> bounds(numChunks + 1);
+	for(int chunk = 0; chunk <= numChunks; chunk++)
+		bounds[chunk] = (int)((long long)count * chunk / numChunks);
+
+	#ifdef _OPENMP
+	#pragma omp parallel for schedule(static, 1)
+	#endif
+	for(int chunk = 0; chunk < numChunks; chunk++)
+		std::sort(begin + bounds[chunk], begin + bounds[chunk + 1]);
+	for(int width = 1; width < numChunks; width *= 2){
+		#ifdef _OPENMP
+		#pragma omp parallel for schedule(static, 1)
+		#endif
+		for(int chunk = 0; chunk < numChunks; chunk += 2 * width)
+			std::inplace_merge(begin + bounds[chunk], begin + bounds[chunk + width], begin + bounds[chunk + 2 * width]);
+	}
+}
+
+// Tells the links lighter than the pivot, for partitioning a range of links
+struct lighterThan{
+	linkEntryT pivot;
+	lighterThan(const linkEntryT &pivot) : pivot(pivot){}
+	bool operator()(const linkEntryT &entry) const{
+		return entry < pivot;
+	}
+};
+
+// Kruskal's algorithm on the given range of links, see filterKruskalSpanningTree
+void filterKruskal(std::vector<linkEntryT>::iterator begin, std::vector<linkEntryT>::iterator end,
+	DisjointSet &forest, int &linksNeeded, std::vector<int> &treeLinkIds, long long &linksLooked){
+	int count = end - begin;
+	if(count == 0 || linksNeeded == 0) return;
+	if(count <= FILTER_KRUSKAL_BASE || count <= linksNeeded + 1){
+		sortLinkEntries(begin, end);
+		for(std::vector<linkEntryT>::iterator entry = begin; entry != end && linksNeeded > 0; ++entry){
+			linksLooked++;
+			if(forest.unite(entry->start, entry->end)){
+				treeLinkIds.push_back(entry->linkId);
+				linksNeeded--;
+			}
+		}
+		return;
+	}
+
+	// The middle one of the first, middle and last link splits the range in light and heavy
+	// links, neither part can be empty since no two links are equal
+	linkEntryT first = *begin, middle = *(begin + count / 2), last = *(end - 1);
+	linkEntryT pivot = middle;
+	if(first < middle){
+		if(last < first) pivot = first;
+		else if(last < middle) pivot = last;
+	}else{
+		if(first < last) pivot = first;
+		else if(middle < last) pivot = last;
+	}
+	std::vector<linkEntryT>::iterator heavy = std::partition(begin, end, lighterThan(pivot));
+	filterKruskal(begin, heavy, forest, linksNeeded, treeLinkIds, linksLooked);
+	if(linksNeeded == 0) return;
+
+	// Heavy links whose ends were joined by the light ones can't be in the tree
+	std::vector<linkEntryT>::iterator kept = heavy;
+	for(std::vector<linkEntryT>::iterator entry = heavy; entry != end; ++entry){
+		linksLooked++;
+		if(forest.find(entry->start) != forest.find(entry->end)) *kept++ = *entry;
+	}
+	filterKruskal(heavy, kept, forest, linksNeeded, treeLinkIds, linksLooked);
+}
+
+// Entries of removed links are marked with the id -1
+bool isRemovedEntry(const linkEntryT &entry){
+	return entry.linkId == -1;
+}
+
+/*
+* Function : filterKruskalSpanningTree
+* Usage    : filterKruskalSpanningTree(graph, treeLinkIds, &stats);
+* -----------------------------------------------------------------
+* Finds the same tree as kruskalSpanningTree, faster on charts with
+* many more links than positions. The links are copied into a flat
+* array, which is split around a pivot cost: the tree of the cheap half
+* is found first, then every link of the expensive half whose ends are
+* already joined is thrown away before that half is handled in turn.
+* Most expensive links are dropped that way without ever being sorted,
+* and only short ranges are sorted and scanned as plain kruskal does.
+* The ids of the kept links are stored in treeLinkIds cheapest first.
+*/
+void filterKruskalSpanningTree(const CSRGraph &graph, std::vector<int> &treeLinkIds, searchStatsT * stats = NULL){
+	(void)stats;    // only counted into when compiled with COLLECT_SEARCH_STATS
+	int numLinks = graph.numLinks();
+	std::vector<linkEntryT> entries(numLinks);
+	#ifdef _OPENMP
+	#pragma omp parallel for schedule(static) if(numLinks >= PARALLEL_SORT_MIN)
+	#endif
+	for(int linkId = 0; linkId < numLinks; linkId++){
+		linkEntryT &entry = entries[linkId];
+		entry.cost = graph.getLinkCost(linkId);
+		entry.start = graph.getLinkStart(linkId);
+		entry.end = graph.getLinkEnd(linkId);
+		entry.linkId = graph.isLinkRemoved(linkId) ? -1 : linkId;
+	}
+	if(graph.numRemovedLinks() > 0)
+		entries.erase(std::remove_if(entries.begin(), entries.end(), isRemovedEntry), entries.end());
+
+	DisjointSet forest(graph.numNodes());
+	int linksNeeded = graph.numNodes() - 1;
+	long long linksLooked = 0;
+	treeLinkIds.clear();
+	filterKruskal(entries.begin(), entries.end(), forest, linksNeeded, treeLinkIds, linksLooked);
+	COUNT_STAT(if(stats != NULL) stats->edgesRelaxed += linksLooked);
+}
+
+#endif
@@ -0,0 +1,204 @@
+/*
+* File : spatialindex.h
+* ----------------------
+* Defines the SpatialIndex class, a uniform grid laid over the
+* coordinates of the positions of a chart that answers "which position
+* is nearest to this point" and "which positions lie within this radius
+* of this point" without looking at every position.
+*
+* Implementation notes
+* ---------------------
+* The bounding box of the points is cut into roughly one cell per point
+* and the points are sorted into the cells in compressed sparse row form
+* (cell offsets plus one array of point ids), so a cell's points are
+* contiguous. A radius query only visits the cells overlapping the
+* square around the circle. A nearest query visits rings of cells around
+* the cell of the query point, growing outwards, and stops as soon as the
+* next ring is farther away than the best point found so far. Distances
+* are compared squared so no sqrt is taken.
+*/
+
+#ifndef SPATIAL_INDEX_H
+#define SPATIAL_INDEX_H
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include "position.h"
+
+class SpatialIndex{
+public:
+	SpatialIndex();
+
+	/*
+	* Function : build
+	* Usage    : index.build(coordinates);
+	* -------------------------------------
+	* Indexes the given points, point i gets the id i. Anything
+	* indexed before is thrown away.
+	*/
+	void build(const std::vector<coordT> &points);
+
+	/*
+	* Function : findNearest
+	* Usage    : int id = index.findNearest(where, maxDistance);
+	* ----------------------------------------------------------
+	* Returns the id of the point nearest to where, or -1 if there is
+	* no point within maxDistance of it (leave out maxDistance to
+	* look arbitrarily far).
+	*/
+	int findNearest(coordT where, double maxDistance = -1);
+
+	/*
+	* Function : findWithin
+	* Usage    : index.findWithin(where, radius, ids);
+	* ------------------------------------------------
+	* Fills ids with the ids of all the points at most radius away
+	* from where, in no particular order.
+	*/
+	void findWithin(coordT where, double radius, std::vector<int> &ids);
+
+private:
+	std::vector<coordT> coords;
+	std::vector<int> cellOffsets;   // numCells+1 entries
+	std::vector<int> cellPoints;    // point ids sorted by cell
+	double minX, minY, cellSize;
+	int numColumns, numRows;
+
+	int columnOf(double x);
+	int rowOf(double y);
+	double squaredDistance(coordT pt1, coordT pt2);
+	void searchCell(int column, int row, coordT where, int &bestId, double &bestDistance);
+};
+
+SpatialIndex::SpatialIndex(){
+	minX = minY = 0;
+	cellSize = 1;
+	numColumns = numRows = 0;
+	cellOffsets.assign(1, 0);
+}
+
+void SpatialIndex::build(const std::vector<coordT> &points){
+	coords = points;
+	int numPoints = coords.size();
+	if(numPoints == 0){
+		numColumns = numRows = 0;
+		cellOffsets.assign(1, 0);
+		cellPoints.clear();
+		return;
+	}
+
+	minX = coords[0].x;
+	minY = coords[0].y;
+	double maxX = minX, maxY = minY;
+	for(int i = 1; i < numPoints; i++){
+		minX = std::min(minX, coords[i].x);
+		maxX = std::max(maxX, coords[i].x);
+		minY = std::min(minY, coords[i].y);
+		maxY = std::max(maxY, coords[i].y);
+	}
+
+	// Square cells sized so that there is about one point per cell
+	double width = std::max(maxX - minX, 1e-9);
+	double height = std::max(maxY - minY, 1e-9);
+	cellSize = std::sqrt(width * height / numPoints);
+	if(cellSize <= 0) cellSize = std::max(width, height);
+	numColumns = std::min((int)(width / cellSize) + 1, numPoints);
+	numRows = std::min((int)(height / cellSize) + 1, numPoints);
+	cellSize = std::max(width / numColumns, height / numRows) * (1 + 1e-9);
+
+	int numCells = numColumns * numRows;
+	std::vector<int> pointCells(numPoints);
+	cellOffsets.assign(numCells + 1, 0);
+	for(int i = 0; i < numPoints; i++){
+		pointCells[i] = rowOf(coords[i].y) * numColumns + columnOf(coords[i].x);
+		cellOffsets[pointCells[i] + 1]++;
+	}
+	for(int cell = 0; cell < numCells; cell++)
+		cellOffsets[cell + 1] += cellOffsets[cell];
+	cellPoints.resize(numPoints);
+	std::vector<int> nextSlot(cellOffsets.begin(), cellOffsets.end() - 1);
+	for(int i = 0; i < numPoints; i++)
+		cellPoints[nextSlot[pointCells[i]]++] = i;
+}
+
+int SpatialIndex::findNearest(coordT where, double maxDistance){
+	if(coords.empty()) return -1;
+	int bestId = -1;
+	double bestDistance = (maxDistance < 0) ? -1 : maxDistance * maxDistance;
+
+	int column = columnOf(where.x);
+	int row = rowOf(where.y);
+	// Distance from the query point to the edge of its own (clamped) cell
+	double cellLeft = minX + column * cellSize, cellBottom = minY + row * cellSize;
+	double slack = std::min(std::min(where.x - cellLeft, cellLeft + cellSize - where.x),
+		std::min(where.y - cellBottom, cellBottom + cellSize - where.y));
+	if(slack < 0) slack = 0;
+
+	int maxRing = std::max(numColumns, numRows);
+	for(int ring = 0; ring <= maxRing; ring++){
+		// Every point in this ring or beyond is at least this far away
+		double ringDistance = (ring - 1) * cellSize + slack;
+		if(ring > 0 && bestDistance >= 0 && ringDistance > 0 && ringDistance * ringDistance > bestDistance) break;
+		for(int r = row - ring; r <= row + ring; r++){
+			if(r < 0 || r >= numRows) continue;
+			bool edgeRow = (r == row - ring || r == row + ring);
+			int step = edgeRow ? 1 : 2 * ring;
+			for(int c = column - ring; c <= column + ring; c += (step == 0 ? 1 : step)){
+				if(c >= 0 && c < numColumns) searchCell(c, r, where, bestId, bestDistance);
+			}
+		}
+	}
+	return bestId;
+}
+
+void SpatialIndex::findWithin(coordT where, double radius, std::vector<int> &ids){
+	ids.clear();
+	if(coords.empty()) return;
+	int firstColumn = std::max(columnOf(where.x - radius), 0);
+	int lastColumn = std::min(columnOf(where.x + radius), numColumns - 1);
+	int firstRow = std::max(rowOf(where.y - radius), 0);
+	int lastRow = std::min(rowOf(where.y + radius), numRows - 1);
+	double squaredRadius = radius * radius;
+	for(int r = firstRow; r <= lastRow; r++){
+		for(int c = firstColumn; c <= lastColumn; c++){
+			int cell = r * numColumns + c;
+			for(int i = cellOffsets[cell]; i < cellOffsets[cell + 1]; i++){
+				if(squaredDistance(where, coords[cellPoints[i]]) <= squaredRadius)
+					ids.push_back(cellPoints[i]);
+			}
+		}
+	}
+}
+
+// Looks for a point in the cell closer than the best one found so far
+void SpatialIndex::searchCell(int column, int row, coordT where, int &bestId, double &bestDistance){
+	int cell = row * numColumns + column;
+	for(int i = cellOffsets[cell]; i < cellOffsets[cell + 1]; i++){
+		double distance = squaredDistance(where, coords[cellPoints[i]]);
+		if(bestDistance < 0 || distance < bestDistance || (distance == bestDistance && bestId == -1)){
+			bestDistance = distance;
+			bestId = cellPoints[i];
+		}
+	}
+}
+
+// Cell column of an x coordinate, clamped to the grid
+int SpatialIndex::columnOf(double x){
+	int column = (int)std::floor((x - minX) / cellSize);
+	return std::max(0, std::min(column, numColumns - 1));
+}
+
+// Cell row of a y coordinate, clamped to the grid
+int SpatialIndex::rowOf(double y){
+	int row = (int)std::floor((y - minY) / cellSize);
+	return std::max(0, std::min(row, numRows - 1));
+}
+
+double SpatialIndex::squaredDistance(coordT pt1, coordT pt2){
+	double dx = pt2.x - pt1.x;
+	double dy = pt2.y - pt1.y;
+	return dx*dx + dy*dy;
+}
+
+#endif
@@ -0,0 +1,79 @@
+/*
+* File : stopwatch.h
+* -------------------
+* Defines the Stopwatch class which measures wall clock time with the
+* finest timer the platform offers, QueryPerformanceCounter on Windows
+* and gettimeofday elsewhere. clock() is no good for this since it
+* counts processor time, summed over every thread of the process.
+*/
+
+#ifndef STOPWATCH_H
+#define STOPWATCH_H
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+class Stopwatch{
+public:
+	/*
+	* Function : Constructor function for the Stopwatch class
+	* Usage    : Stopwatch watch;
+	* ---------------------------------------------------------
+	* The stopwatch starts running right away.
+	*/
+	Stopwatch();
+
+	/*
+	* Function : restart
+	* Usage    : watch.restart();
+	* ----------------------------
+	* Starts timing again from zero.
+	*/
+	void restart();
+
+	/*
+	* Function : getSeconds
+	* Usage    : double seconds = watch.getSeconds();
+	* ------------------------------------------------
+	* Time passed since the stopwatch was started.
+	*/
+	double getSeconds();
+
+private:
+	double startTime;
+
+	static double now();
+};
+
+Stopwatch::Stopwatch(){
+	restart();
+}
+
+void Stopwatch::restart(){
+	startTime = now();
+}
+
+double Stopwatch::getSeconds(){
+	return now() - startTime;
+}
+
+double Stopwatch::now(){
+#ifdef _WIN32
+	LARGE_INTEGER frequency, counter;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+	return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+	struct timeval time;
+	gettimeofday(&time, NULL);
+	return time.tv_sec + time.tv_usec * 1e-6;
+#endif
+}
+
+#endif